@@ -0,0 +1,191 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../bignumbers.h"
+
+// Benchmarks are run by hand and are not part of the test suite:
+//     ./BigNumbersBenchmarks
+
+namespace {
+
+BigInteger randomNumber(size_t limbs, std::mt19937_64& rng)
+{
+    // built from 64-bit pieces with shifts, so the setup stays linear
+    BigInteger result;
+    for (size_t i = 0; i < limbs; i++)
+    {
+        result <<= 64;
+        result |= BigInteger(static_cast<int64_t>(rng() >> 1));
+    }
+    return result;
+}
+
+template <typename Operation>
+double secondsPerCall(Operation operation)
+{
+    // repeat until the measurement covers at least 0.2 seconds
+    size_t calls = 1;
+    while (true)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; i++)
+        {
+            operation();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (elapsed >= 0.2)
+        {
+            return elapsed / static_cast<double>(calls);
+        }
+        calls *= 2;
+    }
+}
+
+void benchmarkSquare()
+{
+    std::mt19937_64 rng(12345);
+
+    std::cout << "square() versus x * x" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(16) << "x * x (us)" << std::setw(16) << "square (us)" << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t limbs : {4, 16, 32, 64, 128, 256, 512, 1024, 4096, 16384})
+    {
+        BigInteger x = randomNumber(limbs, rng);
+        BigInteger y = x;
+        BigInteger result;
+
+        // y is a distinct copy, so x * y takes the general multiplication path
+        double multiply = secondsPerCall([&] { result = x * y; });
+        double square = secondsPerCall([&] { result = x.square(); });
+
+        std::cout << std::setw(10) << limbs
+                  << std::setw(16) << std::fixed << std::setprecision(3) << multiply * 1e6
+                  << std::setw(16) << square * 1e6
+                  << std::setw(10) << std::setprecision(2) << multiply / square << std::endl;
+    }
+}
+
+void benchmarkBarrett()
+{
+    std::mt19937_64 rng(54321);
+
+    std::cout << "BarrettReducer::reduce versus % for a product of two residues" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(16) << "% (us)" << std::setw(16) << "reduce (us)" << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t limbs : {4, 16, 32, 64, 128, 256, 1024, 4096})
+    {
+        BigInteger modulus = randomNumber(limbs, rng) << 3;     // even on purpose
+        BigInteger x = (randomNumber(limbs, rng) * randomNumber(limbs, rng)) % modulus * modulus;
+        x += randomNumber(limbs, rng);
+        BarrettReducer reducer(modulus);
+        BigInteger result;
+
+        double division = secondsPerCall([&] { result = x % modulus; });
+        double barrett = secondsPerCall([&] { result = reducer.reduce(x); });
+
+        std::cout << std::setw(10) << limbs
+                  << std::setw(16) << std::fixed << std::setprecision(3) << division * 1e6
+                  << std::setw(16) << barrett * 1e6
+                  << std::setw(10) << std::setprecision(2) << division / barrett << std::endl;
+    }
+}
+
+void benchmarkGcd()
+{
+    std::mt19937_64 rng(24680);
+
+    std::cout << "gcd versus the euclidean algorithm" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(16) << "euclid (us)" << std::setw(16) << "gcd (us)" << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t limbs : {2, 4, 16, 64, 256, 1024, 4096})
+    {
+        BigInteger a = randomNumber(limbs, rng);
+        BigInteger b = randomNumber(limbs, rng);
+        BigInteger result;
+
+        double euclid = secondsPerCall([&] {
+            BigInteger x = a;
+            BigInteger y = b;
+            while (!y.is_zero())
+            {
+                x %= y;
+                std::swap(x, y);
+            }
+            result = x;
+        });
+        double gcd = secondsPerCall([&] { result = BigInteger::gcd(a, b); });
+
+        std::cout << std::setw(10) << limbs
+                  << std::setw(16) << std::fixed << std::setprecision(3) << euclid * 1e6
+                  << std::setw(16) << gcd * 1e6
+                  << std::setw(10) << std::setprecision(2) << euclid / gcd << std::endl;
+    }
+}
+
+void benchmarkGcdScaling()
+{
+    std::mt19937_64 rng(13579);
+
+    // O(M(n) log n) shows as a ratio to one product that grows by a constant step per doubling
+    std::cout << "gcd against one product of the same size" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(16) << "a * b (ms)" << std::setw(16) << "gcd (ms)" << std::setw(10) << "ratio" << std::endl;
+
+    for (size_t limbs : {512, 1024, 2048, 4096, 8192, 16384, 32768})
+    {
+        BigInteger a = randomNumber(limbs, rng);
+        BigInteger b = randomNumber(limbs, rng);
+        BigInteger result;
+
+        double multiply = secondsPerCall([&] { result = a * b; });
+        double gcd = secondsPerCall([&] { result = BigInteger::gcd(a, b); });
+
+        std::cout << std::setw(10) << limbs
+                  << std::setw(16) << std::fixed << std::setprecision(3) << multiply * 1e3
+                  << std::setw(16) << gcd * 1e3
+                  << std::setw(10) << std::setprecision(2) << gcd / multiply << std::endl;
+    }
+}
+
+void benchmarkRoots()
+{
+    std::mt19937_64 rng(97531);
+
+    std::cout << "integer roots against a division of the same size" << std::endl;
+    std::cout << std::setw(10) << "limbs" << std::setw(16) << "division (us)" << std::setw(16) << "isqrt (us)" << std::setw(16) << "iroot 3 (us)" << std::endl;
+
+    for (size_t limbs : {4, 64, 512, 2048, 8192})
+    {
+        BigInteger a = randomNumber(limbs, rng);
+        BigInteger b = randomNumber(limbs / 2, rng);
+        BigInteger result;
+
+        double division = secondsPerCall([&] { result = a / b; });
+        double sqrt = secondsPerCall([&] { result = a.isqrt(); });
+        double cube = secondsPerCall([&] { result = a.iroot(3); });
+
+        std::cout << std::setw(10) << limbs
+                  << std::setw(16) << std::fixed << std::setprecision(3) << division * 1e6
+                  << std::setw(16) << sqrt * 1e6
+                  << std::setw(16) << cube * 1e6 << std::endl;
+    }
+}
+
+}
+
+int main()
+{
+    benchmarkSquare();
+    std::cout << std::endl;
+    benchmarkBarrett();
+    std::cout << std::endl;
+    benchmarkGcd();
+    std::cout << std::endl;
+    benchmarkGcdScaling();
+    std::cout << std::endl;
+    benchmarkRoots();
+    return 0;
+}
@@ -5,17 +5,339 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <stdexcept>
 #include <valarray>
 #include <random>
 #include <compare>
 #include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <istream>
+#include <ostream>
+#include <bit>
+#include <utility>
+#include <concepts>
+#include <variant>
+#include <tuple>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <span>
 
 #define SUPPORT_IFSTREAM 1
 #define SUPPORT_MORE_OPS 1
 #define SUPPORT_EVAL 1
 
+/*
+ * LimbVector
+ */
+
+// Limb storage for BigInteger: a vector of 64-bit limbs that keeps up to
+// two limbs (128 bits) inline and only allocates for larger values.
+
+class LimbVector
+{
+public:
+    // constructors
+    LimbVector();
+    explicit LimbVector(size_t size, uint64_t value = 0);
+    ~LimbVector();
+
+    // copy
+    LimbVector(const LimbVector& other);
+    LimbVector& operator=(const LimbVector& rhs);
+
+    // move
+    LimbVector(LimbVector&& other) noexcept;
+    LimbVector& operator=(LimbVector&& rhs) noexcept;
+
+    // access
+    size_t size() const;
+    bool empty() const;
+    uint64_t* data();
+    const uint64_t* data() const;
+    uint64_t& operator[](size_t i);
+    const uint64_t& operator[](size_t i) const;
+    uint64_t& back();
+    const uint64_t& back() const;
+    uint64_t* begin();
+    uint64_t* end();
+    const uint64_t* begin() const;
+    const uint64_t* end() const;
+
+    // modifiers
+    void reserve(size_t new_capacity);
+    void resize(size_t new_size, uint64_t value = 0);
+    void assign(size_t new_size, uint64_t value);
+    void assign(const uint64_t* first, const uint64_t* last);
+    void push_back(uint64_t value);
+    void pop_back();
+    void clear();
+    void insert(const uint64_t* position, size_t count, uint64_t value);
+    void erase(const uint64_t* first, const uint64_t* last);
+
+private:
+    static constexpr size_t inline_capacity = 2;
+
+    // realization
+    size_t length;
+    size_t capacity;    // inline_capacity while the limbs live in storage
+    union
+    {
+        uint64_t storage[inline_capacity];
+        uint64_t* heap;
+    };
+
+    // friends
+    friend bool operator==(const LimbVector& lhs, const LimbVector& rhs);
+
+    // assistants
+    bool isInline() const;
+};
+
+/* Constructors */
+
+inline LimbVector::LimbVector() : length(0), capacity(inline_capacity), storage{0, 0} {}
+
+inline LimbVector::LimbVector(size_t size, uint64_t value) : LimbVector()
+{
+    assign(size, value);
+}
+
+inline LimbVector::~LimbVector()
+{
+    if (!isInline())
+    {
+        delete[] heap;
+    }
+}
+
+/* Copy */
+
+inline LimbVector::LimbVector(const LimbVector& other) : LimbVector()
+{
+    assign(other.begin(), other.end());
+}
+
+inline LimbVector& LimbVector::operator=(const LimbVector& rhs) {
+    if (this != &rhs)
+    {
+        assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+}
+
+/* Move */
+
+inline LimbVector::LimbVector(LimbVector&& other) noexcept : LimbVector()
+{
+    *this = std::move(other);
+}
+
+inline LimbVector& LimbVector::operator=(LimbVector&& rhs) noexcept {
+    if (this == &rhs)
+    {
+        return *this;
+    }
+
+    if (rhs.isInline())
+    {
+        // nothing to steal, two limbs are copied
+        length = rhs.length;
+        std::copy(rhs.storage, rhs.storage + rhs.length, data());
+    }
+    else
+    {
+        if (!isInline())
+        {
+            delete[] heap;
+        }
+
+        heap = rhs.heap;
+        length = rhs.length;
+        capacity = rhs.capacity;
+
+        rhs.capacity = inline_capacity;
+    }
+
+    rhs.length = 0;
+    return *this;
+}
+
+/* Access */
+
+inline size_t LimbVector::size() const
+{
+    return length;
+}
+
+inline bool LimbVector::empty() const
+{
+    return length == 0;
+}
+
+inline uint64_t* LimbVector::data()
+{
+    return isInline() ? storage : heap;
+}
+
+inline const uint64_t* LimbVector::data() const
+{
+    return isInline() ? storage : heap;
+}
+
+inline uint64_t& LimbVector::operator[](size_t i)
+{
+    return data()[i];
+}
+
+inline const uint64_t& LimbVector::operator[](size_t i) const
+{
+    return data()[i];
+}
+
+inline uint64_t& LimbVector::back()
+{
+    return data()[length - 1];
+}
+
+inline const uint64_t& LimbVector::back() const
+{
+    return data()[length - 1];
+}
+
+inline uint64_t* LimbVector::begin()
+{
+    return data();
+}
+
+inline uint64_t* LimbVector::end()
+{
+    return data() + length;
+}
+
+inline const uint64_t* LimbVector::begin() const
+{
+    return data();
+}
+
+inline const uint64_t* LimbVector::end() const
+{
+    return data() + length;
+}
+
+/* Modifiers */
+
+inline void LimbVector::reserve(size_t new_capacity)
+{
+    if (new_capacity <= capacity)
+    {
+        return;
+    }
+
+    uint64_t* memory = new uint64_t[new_capacity];
+    std::copy(begin(), end(), memory);
+
+    if (!isInline())
+    {
+        delete[] heap;
+    }
+
+    heap = memory;
+    capacity = new_capacity;
+}
+
+inline void LimbVector::resize(size_t new_size, uint64_t value)
+{
+    if (new_size > capacity)
+    {
+        reserve(std::max(new_size, 2 * capacity));
+    }
+
+    if (new_size > length)
+    {
+        std::fill(data() + length, data() + new_size, value);
+    }
+
+    length = new_size;
+}
+
+inline void LimbVector::assign(size_t new_size, uint64_t value)
+{
+    length = 0;
+    resize(new_size, value);
+}
+
+inline void LimbVector::assign(const uint64_t* first, const uint64_t* last)
+{
+    // the source must not be this vector
+    size_t new_size = last - first;
+
+    length = 0;
+    reserve(new_size);
+    std::copy(first, last, data());
+    length = new_size;
+}
+
+inline void LimbVector::push_back(uint64_t value)
+{
+    if (length == capacity)
+    {
+        reserve(2 * capacity);
+    }
+
+    data()[length++] = value;
+}
+
+inline void LimbVector::pop_back()
+{
+    length--;
+}
+
+inline void LimbVector::clear()
+{
+    length = 0;
+}
+
+inline void LimbVector::insert(const uint64_t* position, size_t count, uint64_t value)
+{
+    size_t offset = position - data();
+    size_t old_size = length;
+
+    resize(length + count);
+
+    uint64_t* memory = data();
+    std::copy_backward(memory + offset, memory + old_size, memory + length);
+    std::fill(memory + offset, memory + offset + count, value);
+}
+
+inline void LimbVector::erase(const uint64_t* first, const uint64_t* last)
+{
+    uint64_t* memory = data();
+    size_t from = first - memory;
+    size_t to = last - memory;
+
+    std::copy(memory + to, memory + length, memory + from);
+    length -= to - from;
+}
+
+/* Friends */
+
+inline bool operator==(const LimbVector& lhs, const LimbVector& rhs)
+{
+    return lhs.length == rhs.length && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+/* Assistants */
+
+inline bool LimbVector::isInline() const
+{
+    return capacity == inline_capacity;
+}
+
 /*
  * BigInteger
  */
@@ -32,9 +354,14 @@ public:
     BigInteger(const BigInteger& other);
     BigInteger& operator=(const BigInteger& rhs);
 
+    // move
+    BigInteger(BigInteger&& other) noexcept;
+    BigInteger& operator=(BigInteger&& rhs) noexcept;
+
     // unary operators
     const BigInteger& operator+() const;
-    BigInteger operator-() const;
+    BigInteger operator-() const&;
+    BigInteger operator-() &&;
 
     // binary arithmetics operators
     BigInteger& operator+=(const BigInteger& rhs);
@@ -43,17 +370,109 @@ public:
     BigInteger& operator/=(const BigInteger& rhs);
     BigInteger& operator%=(const BigInteger& rhs);
 
+    // quotient and remainder of one division, truncated like / and %
+    std::pair<BigInteger, BigInteger> divmod(const BigInteger& rhs) const;
+
+    // quotient of a division known to leave no remainder, cheaper than /; unspecified otherwise
+    BigInteger divexact(const BigInteger& rhs) const;
+
+    // arithmetics with native integers of up to 64 bits, without a temporary BigInteger
+    template <std::integral T> BigInteger& operator+=(T rhs);
+    template <std::integral T> BigInteger& operator-=(T rhs);
+    template <std::integral T> BigInteger& operator*=(T rhs);
+    template <std::integral T> BigInteger& operator/=(T rhs);
+    template <std::integral T> BigInteger& operator%=(T rhs);
+
+    // bitwise operators, negative numbers behave as infinite two's complement
+    BigInteger operator~() const;
+    BigInteger& operator&=(const BigInteger& rhs);
+    BigInteger& operator|=(const BigInteger& rhs);
+    BigInteger& operator^=(const BigInteger& rhs);
+    BigInteger& operator<<=(size_t bits);
+    BigInteger& operator>>=(size_t bits);     // rounds towards negative infinity
+
+    // queries
+    bool is_zero() const;
+    bool is_one() const;
+    bool is_even() const;
+    int sign() const;
+    size_t bit_length() const;      // of the magnitude
+    bool test_bit(size_t i) const;  // of the two's complement
+    size_t popcount() const;        // of the magnitude
+    size_t trailing_zeros() const;
+
+    // conversion, rounded to nearest from the leading limbs; the floating conversions throw
+    // beyond their range and to_int64 unless fits_int64
+    double to_double() const;
+    long double to_long_double() const;
+    std::pair<double, int64_t> frexp() const;     // {m, e}, m * 2^e with 0.5 <= |m| < 1, zero as {0, 0}
+    bool fits_int64() const;
+    int64_t to_int64() const;
+
+    // digits in bases 2 to 36, letters in either case above 9 and written in lowercase,
+    // in linear time for powers of two
+    static BigInteger from_string(const std::string& str, int base = 10);
+    std::string to_string(int base = 10) const;
+
+    // raw bytes like mpz_export and mpz_import: the magnitude, or the two's complement if is_signed,
+    // in the fewest bytes, none for zero
+    std::vector<uint8_t> to_bytes(std::endian order = std::endian::big, bool is_signed = false) const;
+    static BigInteger from_bytes(std::span<const uint8_t> bytes, std::endian order = std::endian::big, bool is_signed = false);
+
+    // versioned binary records: a format version byte, a sign byte, the byte count as a LEB128 varint and
+    // the magnitude in little-endian bytes; deserialize reports the bytes read through consumed or else
+    // expects exactly one record, and throws std::invalid_argument for a malformed or truncated one
+    std::vector<uint8_t> serialize() const;
+    void serialize(std::ostream& out) const;
+    static BigInteger deserialize(std::span<const uint8_t> record, size_t* consumed = nullptr);
+    static BigInteger deserialize(std::istream& in);
+
     // more operators
+    BigInteger square() const;
     double sqrt() const;
+    static BigInteger powmod(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus);
+    static BigInteger pow(const BigInteger& base, uint64_t exponent);
+
+    // number theory, gcd and lcm are non-negative
+    static BigInteger gcd(const BigInteger& a, const BigInteger& b);
+    static BigInteger lcm(const BigInteger& a, const BigInteger& b);
+    static std::tuple<BigInteger, BigInteger, BigInteger> extended_gcd(const BigInteger& a, const BigInteger& b);
+    static BigInteger mod_inverse(const BigInteger& a, const BigInteger& modulus);
+    static BigInteger crt(const std::vector<BigInteger>& residues, const std::vector<BigInteger>& moduli);
 #if SUPPORT_MORE_OPS == 1
     BigInteger isqrt() const;
+    std::pair<BigInteger, BigInteger> sqrtrem() const;  // {isqrt, remainder}
+    BigInteger iroot(uint64_t k) const;                 // truncated k-th root, odd k for negative numbers
+    bool is_perfect_power() const;                      // m^k for some integers m and k >= 2
     bool is_prime(size_t k) const;
 #endif
 
+    // multiplication algorithm thresholds, in limbs of the shorter operand
+    static inline size_t karatsuba_threshold = 40;
+    static inline size_t toom3_threshold = 192;
+    static inline size_t toom4_threshold = 512;
+    static inline size_t ntt_threshold = 2048;
+
+    // divisor size in limbs from which division recurses with Burnikel-Ziegler
+    static inline size_t burnikel_ziegler_threshold = 80;
+
+    // operand size in limbs from which gcd reduces with recursive half-gcd steps instead of lehmer steps,
+    // the recursion collects lehmer steps below a quarter of it
+    static inline size_t half_gcd_threshold = 512;
+
+    // size in limbs from which printing and parsing in a base other than a power of two split at cached
+    // powers of the base, 10^(19 * 2^k) for decimal
+    static inline size_t radix_threshold = 64;
+
 private:
+    using Limbs = LimbVector;
+    using uint128 = unsigned __int128;
+    using int128 = __int128;
+    using GcdMatrix = std::array<BigInteger, 4>;    // {m00, m01, m10, m11}, row major
+
     // realization
-    std::string value;
-    bool sign;
+    Limbs limbs;        // magnitude in base 2^64, least significant limb first, no leading zero limbs
+    bool negative;      // zero is never negative
 
     // friends
     friend std::ostream& operator<<(std::ostream& lhs, const BigInteger& rhs);
@@ -62,6 +481,10 @@ private:
     friend std::istream& operator>>(std::istream& lhs, BigInteger& rhs);
 #endif
 
+    friend BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs);
+
     friend bool operator==(const BigInteger& lhs, const BigInteger& rhs);
     friend bool operator!=(const BigInteger& lhs, const BigInteger& rhs);
     friend bool operator<(const BigInteger& lhs, const BigInteger& rhs);
@@ -69,43 +492,181 @@ private:
     friend bool operator<=(const BigInteger& lhs, const BigInteger& rhs);
     friend bool operator>=(const BigInteger& lhs, const BigInteger& rhs);
 
+    template <std::integral T> friend BigInteger operator%(const BigInteger& lhs, T rhs);
+    template <std::integral T> friend bool operator==(const BigInteger& lhs, T rhs);
+    template <std::integral T> friend std::strong_ordering operator<=>(const BigInteger& lhs, T rhs);
+
     friend class BigRational;
+    friend class BigRationalAccumulator;
+    friend class MontgomeryContext;
+    friend class BarrettReducer;
 
     // assistants
     void removeLeadingZeros();
-    static std::string subtractStrings(const std::string& a, const std::string& b);
-    static std::string addStrings(const std::string& a, const std::string& b);
+    uint128 toNative() const;
+    void assignNative(uint128 magnitude, bool is_negative);
+    static void appendDigits(std::string& result, const BigInteger& x, size_t width, int base);
+    static BigInteger parseDigits(const std::string& digits, size_t from, size_t to, int base);
+    static const BigInteger& radixPower(int base, size_t k);
+    static constexpr std::pair<uint64_t, size_t> radixChunk(int base);
+    static constexpr int digitValue(int c);
+    static constexpr uint8_t record_version = 1;
+    void appendRecordBody(std::vector<uint8_t>& record) const;
+    template <typename Read> static BigInteger readRecord(Read read);
+    template <typename Read> static BigInteger readRecordBody(Read read);
+    static int compareLimbs(const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static uint64_t addLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static uint64_t subtractLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static uint64_t multiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m);
+    static uint64_t addMultiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m);
+    static uint64_t subtractMultiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m);
+    static uint64_t divideLimb(uint64_t* quotient, const uint64_t* a, size_t size, uint64_t d);
+    static void divideExactLimbs(uint64_t* quotient, uint64_t* a, size_t quotient_size, const uint64_t* d, size_t d_size);
+    static void divideKnuth(uint64_t* quotient, uint64_t* remainder, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void multiplySchoolbook(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void multiplyLow(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t count);
+    static void multiplyHigh(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t from);
+    static void multiplyLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void multiplyUnbalanced(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void multiplyKaratsuba(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void multiplyToomCook(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t k);
+    static void multiplyNtt(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void squareSchoolbook(uint64_t* result, const uint64_t* a, size_t size);
+    static void squareLimbs(uint64_t* result, const uint64_t* a, size_t size);
+    static void squareKaratsuba(uint64_t* result, const uint64_t* a, size_t size);
+    template <uint32_t Modulus>
+    static std::vector<uint32_t> convolveNtt(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, size_t size);
+    template <uint32_t Modulus>
+    static void transformNtt(std::vector<uint32_t>& a, bool inverse);
+    static constexpr uint64_t powerModulo(uint64_t base, uint64_t exponent, uint64_t modulus);
+    static constexpr uint64_t inverseLimb(uint64_t odd);
+    static bool differenceLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size);
+    static void accumulateLimbs(uint64_t* result, size_t result_size, const uint64_t* a, size_t a_size);
+    static BigInteger fromLimbs(const uint64_t* data, size_t size);
+    template <std::integral T> static uint64_t nativeMagnitude(T value);
+    void addSmall(uint64_t magnitude, bool is_negative);
+    void multiplySmall(uint64_t magnitude, bool is_negative);
+    uint64_t divideSmall(uint64_t magnitude, bool is_negative);
+    void divideExactSmall(uint64_t magnitude, bool is_negative);
+    uint64_t moduloSmall(uint64_t magnitude) const;
+    int compareSmall(uint64_t magnitude, bool is_negative) const;
+    void addMagnitude(const BigInteger& rhs, bool rhs_negative);
     void divisionAndModulus(const BigInteger& rhs, BigInteger& quotient, BigInteger& remainder) const;
-    static BigInteger modulusPower(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus);
+    static void divideBurnikelZiegler(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+    static void divideTwoByOne(const BigInteger& a, const BigInteger& b, size_t n, BigInteger& quotient, BigInteger& remainder);
+    static void divideThreeByTwo(const BigInteger& a, const BigInteger& b, size_t n, BigInteger& quotient, BigInteger& remainder);
+    BigInteger sliceLimbs(size_t from, size_t count) const;
+    uint64_t bitsFrom(size_t position) const;
+    template <std::floating_point F> std::pair<F, int64_t> roundMantissa() const;
+    template <std::floating_point F> static F scaleMantissa(F mantissa, int64_t exponent);
+    void shiftLimbsLeft(size_t count);
+    void shiftMagnitudeLeft(size_t bits);
+    void shiftMagnitudeRight(size_t bits);
+    template <typename Multiply, typename Square>
+    static BigInteger slidingWindowPower(const BigInteger& base, const BigInteger& exponent, const BigInteger& one, Multiply multiply, Square square);
     static BigInteger randomRange(const BigInteger& low, const BigInteger& high);
-    static size_t bitLength(const BigInteger& number);
+    static std::vector<std::vector<BigInteger>> productTree(const std::vector<BigInteger>& leaves);
+    static uint128 binaryGcd(uint128 a, uint128 b);
+    static std::array<int64_t, 4> lehmerCofactors(const BigInteger& a, const BigInteger& b);
+    static void lehmerUpdate(BigInteger& a, BigInteger& b, const std::array<int64_t, 4>& cofactors);
+    static void lehmerUpdateCoefficients(BigInteger& u, BigInteger& v, const std::array<int64_t, 4>& cofactors);
+    static GcdMatrix halfGcd(BigInteger& a, BigInteger& b, bool with_matrix = true);
+    static GcdMatrix multiplyGcdMatrices(const GcdMatrix& lhs, const GcdMatrix& rhs);
+    static void applyGcdMatrix(GcdMatrix& matrix, BigInteger& a, BigInteger& b, BigInteger&& a_high, BigInteger&& b_high, size_t split);
+#if SUPPORT_MORE_OPS == 1
+    static BigInteger sqrtRemainder(const BigInteger& n, BigInteger& remainder);
+    static BigInteger rootNewton(const BigInteger& n, uint64_t k);
+#endif
+    template <typename Operation>
+    void applyBitwise(const BigInteger& rhs, Operation operation);
+};
+
+/*
+ * MontgomeryContext
+ */
+
+// Arithmetic modulo a fixed odd modulus N in Montgomery form x * R mod N, R = 2^(64 * limbs of N),
+// where a product is reduced with multiplications only. Residues passed to multiply, square and
+// power must be in Montgomery form, as returned by to_montgomery or one.
+
+class MontgomeryContext
+{
+public:
+    // constructors
+    explicit MontgomeryContext(const BigInteger& modulus);
+
+    // conversion
+    BigInteger to_montgomery(const BigInteger& x) const;
+    BigInteger from_montgomery(const BigInteger& x) const;
+
+    // arithmetics
+    BigInteger multiply(const BigInteger& a, const BigInteger& b) const;
+    BigInteger square(const BigInteger& a) const;
+    BigInteger power(const BigInteger& base, const BigInteger& exponent) const;
+
+    // access
+    const BigInteger& modulus() const;
+    const BigInteger& one() const;
+
+private:
+    // realization
+    BigInteger n;
+    size_t size;            // limbs of n
+    uint64_t n_prime;       // -n^-1 mod 2^64
+    BigInteger r_mod;       // R mod n, the Montgomery form of 1
+    BigInteger r_squared;   // R^2 mod n
+
+    // assistants
+    BigInteger reduce(BigInteger::Limbs& t) const;
+};
+
+/*
+ * BarrettReducer
+ */
+
+// Reduction modulo a fixed positive modulus m of k limbs, odd or even, with the reciprocal
+// mu = floor(B^2k / m) precomputed: values below B^2k, which covers every product of two
+// residues, are reduced with two multiplications and at most two subtractions.
+
+class BarrettReducer
+{
+public:
+    // constructors
+    explicit BarrettReducer(const BigInteger& modulus);
+
+    // reduction, the result is in [0, m) for any sign of x
+    BigInteger reduce(const BigInteger& x) const;
+
+    // arithmetics on residues
+    BigInteger multiply(const BigInteger& a, const BigInteger& b) const;
+    BigInteger square(const BigInteger& a) const;
+    BigInteger power(const BigInteger& base, const BigInteger& exponent) const;
+
+    // access
+    const BigInteger& modulus() const;
+
+private:
+    // realization
+    BigInteger m;
+    size_t size;        // limbs of m
+    BigInteger mu;      // floor(B^(2 * size) / m)
 };
 
 /* Constructors */
 
-inline BigInteger::BigInteger() : value("0"), sign(true) {}
+inline BigInteger::BigInteger() : negative(false) {}
 
-inline BigInteger::BigInteger(int64_t n)
+inline BigInteger::BigInteger(int64_t n) : negative(n < 0)
 {
-    if (n == std::numeric_limits<int64_t>::min())
-    {
-        value = "9223372036854775808";
-        sign  = false;
-    }
-    else if (n < 0)
-    {
-        int64_t tmp = -n;
-        value = std::to_string(tmp);
-        sign  = false;
-    }
-    else
+    // two's complement negation keeps INT64_MIN representable
+    uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(n) : static_cast<uint64_t>(n);
+
+    if (magnitude != 0)
     {
-        value = std::to_string(n);
-        sign  = true;
+        limbs.push_back(magnitude);
     }
 }
 
-
 inline BigInteger::BigInteger(const std::string& str)
 {
     if (str.empty())
@@ -117,7 +678,7 @@ inline BigInteger::BigInteger(const std::string& str)
 
     if (str[0] == '-')
     {
-        sign = false;
+        negative = true;
         pos = 1;
     }
     else
@@ -126,16 +687,15 @@ inline BigInteger::BigInteger(const std::string& str)
         {
             pos = 1;
         }
-        sign = true;
+        negative = false;
     }
 
-    value = str.substr(pos);
-
-    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+    if (pos == str.size() || str.find_first_not_of("0123456789", pos) != std::string::npos)
     {
         throw std::invalid_argument("invalid number format");
     }
 
+    limbs = std::move(parseDigits(str, pos, str.size(), 10).limbs);
     removeLeadingZeros();
 }
 
@@ -146,8 +706,29 @@ inline BigInteger::BigInteger(const BigInteger& other) = default;
 inline BigInteger& BigInteger::operator=(const BigInteger& rhs) {
     if (this != &rhs)
     {
-        value = rhs.value;
-        sign = rhs.sign;
+        limbs = rhs.limbs;
+        negative = rhs.negative;
+    }
+    return *this;
+}
+
+/* Move */
+
+inline BigInteger::BigInteger(BigInteger&& other) noexcept : limbs(std::move(other.limbs)), negative(other.negative)
+{
+    // leave a valid zero behind
+    other.limbs.clear();
+    other.negative = false;
+}
+
+inline BigInteger& BigInteger::operator=(BigInteger&& rhs) noexcept {
+    if (this != &rhs)
+    {
+        limbs = std::move(rhs.limbs);
+        negative = rhs.negative;
+
+        rhs.limbs.clear();
+        rhs.negative = false;
     }
     return *this;
 }
@@ -159,766 +740,4141 @@ inline const BigInteger& BigInteger::operator+() const
     return *this;
 }
 
-inline BigInteger BigInteger::operator-() const
+inline BigInteger BigInteger::operator-() const&
 {
     BigInteger result = *this;
+    return -std::move(result);
+}
 
-    if (result.value != "0")
+inline BigInteger BigInteger::operator-() &&
+{
+    if (!limbs.empty())
     {
-        result.sign = !sign;
+        negative = !negative;
     }
 
-    return result;
+    return std::move(*this);
 }
 
 /* Binary arithmetics operators */
 
-inline BigInteger& BigInteger::operator+=(const BigInteger& rhs) {
-    if (sign == rhs.sign)
-    {
-        value = addStrings(value, rhs.value);
-    }
-    else
-    {
-        if (value == rhs.value)
-        {
-            value = "0";
-            sign = true;
-        }
-        else if (value.size() > rhs.value.size() || (value.size() == rhs.value.size() && value > rhs.value))
-        {
-            value = subtractStrings(value, rhs.value);
-        }
-        else
-        {
-            value = subtractStrings(rhs.value, value);
-            sign = rhs.sign;
-        }
-    }
+// Overloads taking an expiring operand reuse its limbs, so chained
+// expressions only allocate for the products they actually form.
 
-    removeLeadingZeros();
+inline BigInteger& BigInteger::operator+=(const BigInteger& rhs) {
+    addMagnitude(rhs, rhs.negative);
     return *this;
 }
 
-inline BigInteger operator+(BigInteger lhs, const BigInteger& rhs)
+inline BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs)
+{
+    BigInteger result;
+    result.limbs.reserve(std::max(lhs.limbs.size(), rhs.limbs.size()) + 1);     // room for the carry
+    result = lhs;
+    result += rhs;
+    return result;
+}
+
+inline BigInteger operator+(BigInteger&& lhs, const BigInteger& rhs)
 {
     lhs += rhs;
-    return lhs;
+    return std::move(lhs);
+}
+
+inline BigInteger operator+(const BigInteger& lhs, BigInteger&& rhs)
+{
+    rhs += lhs;
+    return std::move(rhs);
+}
+
+inline BigInteger operator+(BigInteger&& lhs, BigInteger&& rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
 }
 
 inline BigInteger& BigInteger::operator-=(const BigInteger& rhs) {
-    if (sign != rhs.sign)
-    {
-        value = addStrings(value, rhs.value);
-    }
-    else
-    {
-        if (value == rhs.value)
-        {
-            value = "0";
-            sign = true;
-        }
-        else if (value.size() > rhs.value.size() || (value.size() == rhs.value.size() && value > rhs.value))
-        {
-            value = subtractStrings(value, rhs.value);
-        }
-        else
-        {
-            value = subtractStrings(rhs.value, value);
-            sign = !sign;
-        }
-    }
-
-    removeLeadingZeros();
+    addMagnitude(rhs, !rhs.negative);
     return *this;
 }
 
-inline BigInteger operator-(BigInteger lhs, const BigInteger& rhs)
+inline BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs)
+{
+    BigInteger result;
+    result.limbs.reserve(std::max(lhs.limbs.size(), rhs.limbs.size()) + 1);
+    result = lhs;
+    result -= rhs;
+    return result;
+}
+
+inline BigInteger operator-(BigInteger&& lhs, const BigInteger& rhs)
 {
     lhs -= rhs;
-    return lhs;
+    return std::move(lhs);
+}
+
+inline BigInteger operator-(const BigInteger& lhs, BigInteger&& rhs)
+{
+    // lhs - rhs = -(rhs - lhs)
+    rhs -= lhs;
+    return -std::move(rhs);
+}
+
+inline BigInteger operator-(BigInteger&& lhs, BigInteger&& rhs)
+{
+    lhs -= rhs;
+    return std::move(lhs);
 }
 
 inline BigInteger& BigInteger::operator*=(const BigInteger& rhs) {
-    if (value == "0" || rhs.value == "0")
+    *this = *this * rhs;
+    return *this;
+}
+
+inline BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs)
+{
+    // the product never fits in place, so both operands are only read
+    BigInteger result;
+
+    if (lhs.limbs.empty() || rhs.limbs.empty())
     {
-        value = "0";
-        sign = true;
-        return *this;
+        return result;
     }
 
-    sign = (sign == rhs.sign);
+    size_t lhs_size = lhs.limbs.size();
+    size_t rhs_size = rhs.limbs.size();
 
-    std::string result(value.size() + rhs.value.size(), '0');
+    if (lhs_size == 1 && rhs_size == 1)
+    {
+        // single limbs, the product fits in native 128 bits
+        result.assignNative(static_cast<BigInteger::uint128>(lhs.limbs[0]) * rhs.limbs[0], lhs.negative != rhs.negative);
+        return result;
+    }
 
-    for (int i = value.size() - 1; i >= 0; i--)
+    result.limbs.resize(lhs_size + rhs_size);
+
+    if (lhs_size >= rhs_size)
     {
-        int carry = 0;
-        int num1 = value[i] - '0';
-        for (int j = rhs.value.size() - 1; j >= 0; j--)
-        {
-            int num2 = rhs.value[j] - '0';
-            int sum = (result[i + j + 1] - '0') + num1 * num2 + carry;
-            carry = sum / 10;
-            result[i + j + 1] = (sum % 10) + '0';
-        }
-        result[i] += carry;
+        BigInteger::multiplyLimbs(result.limbs.data(), lhs.limbs.data(), lhs_size, rhs.limbs.data(), rhs_size);
+    }
+    else
+    {
+        BigInteger::multiplyLimbs(result.limbs.data(), rhs.limbs.data(), rhs_size, lhs.limbs.data(), lhs_size);
     }
 
-    value = result;
-    removeLeadingZeros();
+    result.negative = (lhs.negative != rhs.negative);
+    result.removeLeadingZeros();
+    return result;
+}
+
+inline BigInteger& BigInteger::operator/=(const BigInteger& rhs) {
+    BigInteger quotient;
+    BigInteger remainder;
+    divisionAndModulus(rhs, quotient, remainder);
+
+    *this = std::move(quotient);
     return *this;
 }
 
-inline BigInteger operator*(BigInteger lhs, const BigInteger& rhs)
+inline BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs)
 {
-    lhs *= rhs;
-    return lhs;
+    return lhs.divmod(rhs).first;
 }
 
-inline BigInteger& BigInteger::operator/=(const BigInteger& rhs) {
+inline BigInteger& BigInteger::operator%=(const BigInteger& rhs) {
     BigInteger quotient;
     BigInteger remainder;
     divisionAndModulus(rhs, quotient, remainder);
 
-    *this = quotient;
+    *this = std::move(remainder);
     return *this;
 }
 
-inline BigInteger operator/(BigInteger lhs, const BigInteger& rhs)
+inline BigInteger operator%(const BigInteger& lhs, const BigInteger& rhs)
 {
-    lhs /= rhs;
-    return lhs;
+    return lhs.divmod(rhs).second;
 }
 
-inline BigInteger& BigInteger::operator%=(const BigInteger& rhs) {
+inline std::pair<BigInteger, BigInteger> BigInteger::divmod(const BigInteger& rhs) const
+{
     BigInteger quotient;
     BigInteger remainder;
     divisionAndModulus(rhs, quotient, remainder);
 
-    *this = remainder;
+    return {std::move(quotient), std::move(remainder)};
+}
+
+inline BigInteger BigInteger::divexact(const BigInteger& rhs) const
+{
+    // Jebelean's exact division: as a = q * d, the low limbs of q follow one by one from the low
+    // limbs of a times d^-1 mod 2^64, and only the limbs below the quotient length are ever updated
+    if (rhs.is_zero())
+    {
+        throw std::logic_error("zero division");
+    }
+    if (limbs.size() < rhs.limbs.size())
+    {
+        return BigInteger(0);
+    }
+
+    BigInteger result = *this;
+    if (rhs.limbs.size() == 1)
+    {
+        result.divideExactSmall(rhs.limbs[0], rhs.negative);
+        return result;
+    }
+
+    size_t quotient_size = limbs.size() - rhs.limbs.size() + 1;
+    if (std::min(quotient_size, rhs.limbs.size()) >= 12 * burnikel_ziegler_threshold)
+    {
+        // the sweep is quadratic, and the recursive division catches up with it only once both
+        // the quotient and the divisor are well into its range, about a thousand limbs by default
+        return *this / rhs;
+    }
+
+    // a common power of two is shifted out first, the divisor is then odd and invertible
+    size_t shift = rhs.trailing_zeros();
+    BigInteger divisor;
+    if (shift != 0)
+    {
+        divisor = rhs;
+        divisor.shiftMagnitudeRight(shift);
+        result.shiftMagnitudeRight(shift);
+        quotient_size = result.limbs.size() - divisor.limbs.size() + 1;
+    }
+    const Limbs& d = shift != 0 ? divisor.limbs : rhs.limbs;
+
+    Limbs quotient(quotient_size, 0);
+    divideExactLimbs(quotient.data(), result.limbs.data(), quotient_size, d.data(), d.size());
+
+    result.limbs = std::move(quotient);
+    result.negative = (negative != rhs.negative);
+    result.removeLeadingZeros();
+    return result;
+}
+
+/* Mixed arithmetics operators */
+
+template <std::integral T>
+inline BigInteger& BigInteger::operator+=(T rhs) {
+    addSmall(nativeMagnitude(rhs), std::cmp_less(rhs, 0));
     return *this;
 }
 
-inline BigInteger operator%(BigInteger lhs, const BigInteger& rhs)
+template <std::integral T>
+inline BigInteger operator+(const BigInteger& lhs, T rhs)
 {
-    lhs %= rhs;
-    return lhs;
+    BigInteger result = lhs;
+    result += rhs;
+    return result;
 }
 
-/* Logical operators */
+template <std::integral T>
+inline BigInteger operator+(BigInteger&& lhs, T rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
+}
 
-inline bool operator==(const BigInteger& lhs, const BigInteger& rhs)
+template <std::integral T>
+inline BigInteger operator+(T lhs, const BigInteger& rhs)
 {
-    return lhs.sign == rhs.sign && lhs.value == rhs.value;
+    return rhs + lhs;
 }
 
-inline bool operator!=(const BigInteger& lhs, const BigInteger& rhs)
+template <std::integral T>
+inline BigInteger& BigInteger::operator-=(T rhs) {
+    addSmall(nativeMagnitude(rhs), !std::cmp_less(rhs, 0));
+    return *this;
+}
+
+template <std::integral T>
+inline BigInteger operator-(const BigInteger& lhs, T rhs)
 {
-    return !(lhs == rhs);
+    BigInteger result = lhs;
+    result -= rhs;
+    return result;
 }
 
-inline bool operator<(const BigInteger& lhs, const BigInteger& rhs)
+template <std::integral T>
+inline BigInteger operator-(BigInteger&& lhs, T rhs)
 {
-    if (lhs.sign != rhs.sign)
-    {
-        return !lhs.sign;
-    }
+    lhs -= rhs;
+    return std::move(lhs);
+}
 
-    if (lhs.sign)
-    {
-        if (lhs.value.size() != rhs.value.size())
-        {
-            return lhs.value.size() < rhs.value.size();
-        }
-        return lhs.value < rhs.value;
-    }
+template <std::integral T>
+inline BigInteger operator-(T lhs, const BigInteger& rhs)
+{
+    BigInteger result = -rhs;
+    result += lhs;
+    return result;
+}
+
+template <std::integral T>
+inline BigInteger& BigInteger::operator*=(T rhs) {
+    multiplySmall(nativeMagnitude(rhs), std::cmp_less(rhs, 0));
+    return *this;
+}
+
+template <std::integral T>
+inline BigInteger operator*(const BigInteger& lhs, T rhs)
+{
+    BigInteger result = lhs;
+    result *= rhs;
+    return result;
+}
+
+template <std::integral T>
+inline BigInteger operator*(BigInteger&& lhs, T rhs)
+{
+    lhs *= rhs;
+    return std::move(lhs);
+}
+
+template <std::integral T>
+inline BigInteger operator*(T lhs, const BigInteger& rhs)
+{
+    return rhs * lhs;
+}
+
+template <std::integral T>
+inline BigInteger& BigInteger::operator/=(T rhs) {
+    divideSmall(nativeMagnitude(rhs), std::cmp_less(rhs, 0));
+    return *this;
+}
+
+template <std::integral T>
+inline BigInteger operator/(const BigInteger& lhs, T rhs)
+{
+    BigInteger result = lhs;
+    result /= rhs;
+    return result;
+}
+
+template <std::integral T>
+inline BigInteger operator/(BigInteger&& lhs, T rhs)
+{
+    lhs /= rhs;
+    return std::move(lhs);
+}
 
-    if (lhs.value.size() != rhs.value.size())
+template <std::integral T>
+inline BigInteger& BigInteger::operator%=(T rhs) {
+    assignNative(moduloSmall(nativeMagnitude(rhs)), negative);
+    return *this;
+}
+
+template <std::integral T>
+inline BigInteger operator%(const BigInteger& lhs, T rhs)
+{
+    // the remainder takes the sign of the dividend, like operator%(BigInteger, BigInteger)
+    BigInteger result;
+    result.assignNative(lhs.moduloSmall(BigInteger::nativeMagnitude(rhs)), lhs.negative);
+    return result;
+}
+
+/* Bitwise operators */
+
+inline BigInteger BigInteger::operator~() const
+{
+    // ~x == -x - 1
+    BigInteger result = -*this;
+    result -= 1;
+    return result;
+}
+
+inline BigInteger& BigInteger::operator&=(const BigInteger& rhs) {
+    applyBitwise(rhs, [](uint64_t a, uint64_t b) { return a & b; });
+    return *this;
+}
+
+inline BigInteger operator&(const BigInteger& lhs, const BigInteger& rhs)
+{
+    BigInteger result = lhs;
+    result &= rhs;
+    return result;
+}
+
+inline BigInteger operator&(BigInteger&& lhs, const BigInteger& rhs)
+{
+    lhs &= rhs;
+    return std::move(lhs);
+}
+
+inline BigInteger& BigInteger::operator|=(const BigInteger& rhs) {
+    applyBitwise(rhs, [](uint64_t a, uint64_t b) { return a | b; });
+    return *this;
+}
+
+inline BigInteger operator|(const BigInteger& lhs, const BigInteger& rhs)
+{
+    BigInteger result = lhs;
+    result |= rhs;
+    return result;
+}
+
+inline BigInteger operator|(BigInteger&& lhs, const BigInteger& rhs)
+{
+    lhs |= rhs;
+    return std::move(lhs);
+}
+
+inline BigInteger& BigInteger::operator^=(const BigInteger& rhs) {
+    applyBitwise(rhs, [](uint64_t a, uint64_t b) { return a ^ b; });
+    return *this;
+}
+
+inline BigInteger operator^(const BigInteger& lhs, const BigInteger& rhs)
+{
+    BigInteger result = lhs;
+    result ^= rhs;
+    return result;
+}
+
+inline BigInteger operator^(BigInteger&& lhs, const BigInteger& rhs)
+{
+    lhs ^= rhs;
+    return std::move(lhs);
+}
+
+inline BigInteger& BigInteger::operator<<=(size_t bits) {
+    shiftMagnitudeLeft(bits);
+    return *this;
+}
+
+inline BigInteger operator<<(const BigInteger& lhs, size_t bits)
+{
+    BigInteger result = lhs;
+    result <<= bits;
+    return result;
+}
+
+inline BigInteger operator<<(BigInteger&& lhs, size_t bits)
+{
+    lhs <<= bits;
+    return std::move(lhs);
+}
+
+inline BigInteger& BigInteger::operator>>=(size_t bits) {
+    // a negative number moves one further down when any of the dropped bits is set
+    bool round_down = negative && trailing_zeros() < bits;
+
+    shiftMagnitudeRight(bits);
+
+    if (round_down)
     {
-        return lhs.value.size() > rhs.value.size();
+        addSmall(1, true);
     }
-    return lhs.value > rhs.value;
+    return *this;
 }
 
-inline bool operator>(const BigInteger& lhs, const BigInteger& rhs)
+inline BigInteger operator>>(const BigInteger& lhs, size_t bits)
 {
-    return rhs < lhs;
+    BigInteger result = lhs;
+    result >>= bits;
+    return result;
 }
 
-inline bool operator<=(const BigInteger& lhs, const BigInteger& rhs)
+inline BigInteger operator>>(BigInteger&& lhs, size_t bits)
 {
-    return !(rhs < lhs);
+    lhs >>= bits;
+    return std::move(lhs);
 }
 
-inline bool operator>=(const BigInteger& lhs, const BigInteger& rhs)
+/* Queries */
+
+inline bool BigInteger::is_zero() const
 {
-    return !(lhs < rhs);
+    return limbs.empty();
 }
 
-/* Friends */
+inline bool BigInteger::is_one() const
+{
+    return !negative && limbs.size() == 1 && limbs[0] == 1;
+}
 
-inline std::ostream& operator<<(std::ostream& lhs, const BigInteger& rhs)
+inline bool BigInteger::is_even() const
+{
+    return limbs.empty() || (limbs[0] & 1) == 0;
+}
+
+inline int BigInteger::sign() const
+{
+    return limbs.empty() ? 0 : (negative ? -1 : 1);
+}
+
+inline size_t BigInteger::bit_length() const
 {
-    if (!rhs.sign)
+    if (limbs.empty())
     {
-        lhs << '-';
+        return 0;
     }
 
-    lhs << rhs.value;
+    return 64 * limbs.size() - std::countl_zero(limbs.back());
+}
 
-    return lhs;
+inline bool BigInteger::test_bit(size_t i) const
+{
+    bool bit = i / 64 < limbs.size() && ((limbs[i / 64] >> (i % 64)) & 1) != 0;
+
+    if (!negative)
+    {
+        return bit;
+    }
+
+    // -m == ~(m - 1): the bits up to the lowest set one are unchanged, the rest inverted
+    size_t lowest = trailing_zeros();
+    return i <= lowest ? bit : !bit;
 }
 
-#if SUPPORT_IFSTREAM == 1
+inline size_t BigInteger::popcount() const
+{
+    size_t count = 0;
+    for (uint64_t limb : limbs)
+    {
+        count += std::popcount(limb);
+    }
+    return count;
+}
 
-inline bool readBigInteger(std::istream& in, BigInteger& x)
+inline size_t BigInteger::trailing_zeros() const
 {
-    x = BigInteger(0);
+    // zero has no set bit and reports 0
+    for (size_t i = 0; i < limbs.size(); i++)
+    {
+        if (limbs[i] != 0)
+        {
+            return 64 * i + std::countr_zero(limbs[i]);
+        }
+    }
+    return 0;
+}
 
-    std::istream::sentry s(in);
-    if (!s)
+/* Conversion */
+
+inline double BigInteger::to_double() const
+{
+    auto [mantissa, exponent] = roundMantissa<double>();
+    return scaleMantissa(mantissa, exponent);
+}
+
+inline long double BigInteger::to_long_double() const
+{
+    auto [mantissa, exponent] = roundMantissa<long double>();
+    return scaleMantissa(mantissa, exponent);
+}
+
+inline std::pair<double, int64_t> BigInteger::frexp() const
+{
+    return roundMantissa<double>();
+}
+
+inline bool BigInteger::fits_int64() const
+{
+    return limbs.empty() || (limbs.size() == 1 && limbs[0] <= static_cast<uint64_t>(INT64_MAX) + negative);
+}
+
+inline int64_t BigInteger::to_int64() const
+{
+    if (!fits_int64())
     {
-        in.setstate(std::ios::failbit);
-        return false;
+        throw std::runtime_error("large number");
     }
 
-    bool negative = false;
-    bool found_digit = false;
+    uint64_t magnitude = is_zero() ? 0 : limbs[0];
+    return static_cast<int64_t>(negative ? 0 - magnitude : magnitude);
+}
 
-    std::string digits;
-    digits.reserve(128);
+inline BigInteger BigInteger::from_string(const std::string& str, int base)
+{
+    if (base < 2 || base > 36)
+    {
+        throw std::invalid_argument("invalid base");
+    }
 
-    int c = in.peek();      // sign
-    if (c == '+' || c == '-')
+    if (str.empty())
     {
-        negative = (c == '-');
-        in.ignore(1);
+        throw std::invalid_argument("empty string");
     }
 
-    while (true)    // digits
+    size_t pos = str[0] == '-' || str[0] == '+' ? 1 : 0;
+    if (pos == str.size() || std::any_of(str.begin() + pos, str.end(), [base](char c) { return digitValue(c) >= base; }))
     {
-        c = in.peek();
+        throw std::invalid_argument("invalid number format");
+    }
+
+    BigInteger result = parseDigits(str, pos, str.size(), base);
+    result.negative = str[0] == '-' && !result.is_zero();
+    return result;
+}
+
+inline std::string BigInteger::to_string(int base) const
+{
+    if (base < 2 || base > 36)
+    {
+        throw std::invalid_argument("invalid base");
+    }
+
+    if (limbs.empty())
+    {
+        return "0";
+    }
+
+    std::string result = negative ? "-" : "";
+    result.reserve(limbs.size() * (radixChunk(base).second + 1) + 1);     // base^(digits + 1) exceeds a limb
+    appendDigits(result, negative ? -*this : *this, 0, base);
+    return result;
+}
+
+inline std::vector<uint8_t> BigInteger::to_bytes(std::endian order, bool is_signed) const
+{
+    if (is_zero())
+    {
+        return {};
+    }
+
+    // -m in two's complement is the complement of m - 1, which needs a clear top bit like a positive value
+    BigInteger magnitude = negative ? -*this : *this;
+    bool complement = negative && is_signed;
+    if (complement)
+    {
+        magnitude -= 1;
+    }
+
+    size_t bits = magnitude.bit_length() + (is_signed ? 1 : 0);
+    std::vector<uint8_t> bytes((bits + 7) / 8);
+    for (size_t i = 0; i < bytes.size(); i++)
+    {
+        uint64_t limb = i / 8 < magnitude.limbs.size() ? magnitude.limbs[i / 8] : 0;
+        bytes[i] = static_cast<uint8_t>((limb >> (8 * (i % 8))) ^ (complement ? 0xff : 0));
+    }
+
+    if (order == std::endian::big)
+    {
+        std::reverse(bytes.begin(), bytes.end());
+    }
+    return bytes;
+}
+
+inline BigInteger BigInteger::from_bytes(std::span<const uint8_t> bytes, std::endian order, bool is_signed)
+{
+    size_t size = bytes.size();
+    auto byte = [&](size_t i) { return order == std::endian::little ? bytes[i] : bytes[size - 1 - i]; };
+
+    // a set top bit of a signed value stands for -(complement + 1)
+    bool complement = is_signed && size > 0 && (byte(size - 1) & 0x80) != 0;
+
+    BigInteger result;
+    result.limbs.resize((size + 7) / 8);
+    for (size_t i = 0; i < size; i++)
+    {
+        result.limbs[i / 8] |= static_cast<uint64_t>(complement ? byte(i) ^ 0xff : byte(i)) << (8 * (i % 8));
+    }
+    result.removeLeadingZeros();
+
+    if (complement)
+    {
+        result += 1;
+        result.negative = true;
+    }
+    return result;
+}
+
+inline std::vector<uint8_t> BigInteger::serialize() const
+{
+    std::vector<uint8_t> record = {record_version};
+    appendRecordBody(record);
+    return record;
+}
+
+inline void BigInteger::serialize(std::ostream& out) const
+{
+    std::vector<uint8_t> record = serialize();
+    out.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+}
+
+inline BigInteger BigInteger::deserialize(std::span<const uint8_t> record, size_t* consumed)
+{
+    size_t offset = 0;
+    auto read = [&](uint8_t* destination, size_t count)
+    {
+        if (count > record.size() - offset)
+        {
+            throw std::invalid_argument("truncated record");
+        }
+        std::copy_n(record.data() + offset, count, destination);
+        offset += count;
+    };
+
+    BigInteger result = readRecord(read);
+    if (consumed != nullptr)
+    {
+        *consumed = offset;
+    }
+    else if (offset != record.size())
+    {
+        throw std::invalid_argument("malformed record");
+    }
+    return result;
+}
+
+inline BigInteger BigInteger::deserialize(std::istream& in)
+{
+    auto read = [&in](uint8_t* destination, size_t count)
+    {
+        if (!in.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(count)))
+        {
+            throw std::invalid_argument("truncated record");
+        }
+    };
+
+    return readRecord(read);
+}
+
+/* Logical operators */
+
+inline bool operator==(const BigInteger& lhs, const BigInteger& rhs)
+{
+    return lhs.negative == rhs.negative && lhs.limbs == rhs.limbs;
+}
+
+inline bool operator!=(const BigInteger& lhs, const BigInteger& rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator<(const BigInteger& lhs, const BigInteger& rhs)
+{
+    if (lhs.negative != rhs.negative)
+    {
+        return lhs.negative;
+    }
+
+    int cmp = BigInteger::compareLimbs(lhs.limbs.data(), lhs.limbs.size(), rhs.limbs.data(), rhs.limbs.size());
+
+    return lhs.negative ? cmp > 0 : cmp < 0;
+}
+
+inline bool operator>(const BigInteger& lhs, const BigInteger& rhs)
+{
+    return rhs < lhs;
+}
+
+inline bool operator<=(const BigInteger& lhs, const BigInteger& rhs)
+{
+    return !(rhs < lhs);
+}
+
+inline bool operator>=(const BigInteger& lhs, const BigInteger& rhs)
+{
+    return !(lhs < rhs);
+}
+
+/* Mixed logical operators */
+
+// the remaining comparisons, in either order, are rewritten from these two
+
+template <std::integral T>
+inline bool operator==(const BigInteger& lhs, T rhs)
+{
+    return lhs.compareSmall(BigInteger::nativeMagnitude(rhs), std::cmp_less(rhs, 0)) == 0;
+}
+
+template <std::integral T>
+inline std::strong_ordering operator<=>(const BigInteger& lhs, T rhs)
+{
+    return lhs.compareSmall(BigInteger::nativeMagnitude(rhs), std::cmp_less(rhs, 0)) <=> 0;
+}
+
+/* Friends */
+
+inline std::ostream& operator<<(std::ostream& lhs, const BigInteger& rhs)
+{
+    // std::hex and std::oct select the base, std::showbase and std::uppercase apply as for native integers
+    std::ios::fmtflags flags = lhs.flags();
+    int base = (flags & std::ios::basefield) == std::ios::hex ? 16 : (flags & std::ios::basefield) == std::ios::oct ? 8 : 10;
+
+    std::string result = rhs.to_string(base);
+    if (base != 10 && (flags & std::ios::showbase) && !rhs.is_zero())
+    {
+        result.insert(rhs.negative ? 1 : 0, base == 16 ? "0x" : "0");
+    }
+    if (base == 16 && (flags & std::ios::uppercase))
+    {
+        std::transform(result.begin(), result.end(), result.begin(), [](char c) { return static_cast<char>(std::toupper(c)); });
+    }
+
+    lhs << result;
+
+    return lhs;
+}
+
+#if SUPPORT_IFSTREAM == 1
+
+inline bool readBigInteger(std::istream& in, BigInteger& x)
+{
+    x = BigInteger(0);
+
+    std::istream::sentry s(in);
+    if (!s)
+    {
+        in.setstate(std::ios::failbit);
+        return false;
+    }
+
+    // std::hex and std::oct select the base, hexadecimal digits may follow a 0x
+    std::ios::fmtflags flags = in.flags();
+    int base = (flags & std::ios::basefield) == std::ios::hex ? 16 : (flags & std::ios::basefield) == std::ios::oct ? 8 : 10;
+
+    bool negative = false;
+    bool found_digit = false;
+
+    std::string digits;
+    digits.reserve(128);
+
+    int c = in.peek();      // sign
+    if (c == '+' || c == '-')
+    {
+        negative = (c == '-');
+        in.ignore(1);
+    }
+
+    if (base == 16 && in.peek() == '0')     // prefix
+    {
+        in.ignore(1);
+        digits.push_back('0');
+        found_digit = true;
+        if (in.peek() == 'x' || in.peek() == 'X')
+        {
+            // the x belongs to the prefix only when a hexadecimal digit follows, "0xg" reads 0 and leaves "xg"
+            in.ignore(1);
+            if (BigInteger::digitValue(in.peek()) >= base && !in.unget())
+            {
+                return false;
+            }
+        }
+    }
+
+    while (true)    // digits
+    {
+        c = in.peek();
+
+        if (BigInteger::digitValue(c) >= base)
+        {
+            break;
+        }
+
+        digits.push_back(static_cast<char>(c));
+        found_digit = true;
+        in.ignore(1);
+    }
+
+    if (!found_digit)
+    {
+        in.setstate(std::ios::failbit);
+        return false;
+    }
+
+    x.limbs = std::move(BigInteger::parseDigits(digits, 0, digits.size(), base).limbs);
+    x.negative = negative;
+    x.removeLeadingZeros();
+
+    return true;
+}
+
+inline std::istream& operator>>(std::istream& lhs, BigInteger& rhs)
+{
+    bool success = readBigInteger(lhs, rhs);
+    if (!success)
+    {
+        if (!lhs.fail())
+        {
+            lhs.setstate(std::ios::failbit);
+        }
+    }
+    return lhs;
+}
+
+#endif
+
+/* More operators */
+
+inline BigInteger BigInteger::square() const
+{
+    BigInteger result;
+
+    if (limbs.size() == 1)
+    {
+        result.assignNative(static_cast<uint128>(limbs[0]) * limbs[0], false);
+    }
+    else if (!limbs.empty())
+    {
+        result.limbs.resize(2 * limbs.size());
+        squareLimbs(result.limbs.data(), limbs.data(), limbs.size());
+        result.removeLeadingZeros();
+    }
+
+    return result;
+}
+
+inline double BigInteger::sqrt() const
+{
+    if (negative)
+    {
+        throw std::runtime_error("negative number");
+    }
+
+    // halving an even exponent keeps the root in range wherever it is representable
+    auto [mantissa, exponent] = frexp();
+    if (exponent % 2 != 0)
+    {
+        mantissa *= 2;
+        --exponent;
+    }
+    return scaleMantissa(std::sqrt(mantissa), exponent / 2);
+}
+
+inline BigInteger BigInteger::powmod(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus)
+{
+    // base^exponent mod |modulus|, in [0, |modulus|)
+    if (modulus.is_zero())
+    {
+        throw std::invalid_argument("zero modulus");
+    }
+
+    if (exponent.sign() < 0)
+    {
+        throw std::invalid_argument("negative exponent");
+    }
+
+    BigInteger m = modulus.negative ? -modulus : modulus;
+
+    if (m.is_one())
+    {
+        return BigInteger(0);
+    }
+
+    if (!m.is_even())
+    {
+        MontgomeryContext context(m);
+        return context.from_montgomery(context.power(context.to_montgomery(base), exponent));
+    }
+
+    BarrettReducer reducer(m);
+    return reducer.power(base, exponent);
+}
+
+inline BigInteger BigInteger::pow(const BigInteger& base, uint64_t exponent)
+{
+    // left-to-right binary: without a modulus the squarings of the growing result dominate,
+    // so a window of odd powers would not save anything
+    BigInteger result(1);
+
+    for (int i = std::bit_width(exponent); i-- > 0;)
+    {
+        result = result.square();
+        if ((exponent >> i) & 1)
+        {
+            result *= base;
+        }
+    }
+
+    return result;
+}
+
+inline BigInteger BigInteger::gcd(const BigInteger& a, const BigInteger& b)
+{
+    // half-gcd steps while the operands are huge, lehmer steps on the leading bits below,
+    // and a binary gcd once both fit into two limbs
+    BigInteger x = a.negative ? -a : a;
+    BigInteger y = b.negative ? -b : b;
+    if (compareLimbs(x.limbs.data(), x.limbs.size(), y.limbs.data(), y.limbs.size()) < 0)
+    {
+        std::swap(x, y);
+    }
+
+    while (y.limbs.size() > 2)
+    {
+        std::array<int64_t, 4> cofactors;
+        if (y.limbs.size() >= half_gcd_threshold && y.limbs.size() > x.limbs.size() / 2 + 1)
+        {
+            halfGcd(x, y, false);
+        }
+        else if ((cofactors = lehmerCofactors(x, y))[1] == 0)
+        {
+            // the leading bits do not determine a quotient, e.g. operands of very different length
+            BigInteger remainder = x % y;
+            x = std::move(y);
+            y = std::move(remainder);
+        }
+        else
+        {
+            lehmerUpdate(x, y, cofactors);
+        }
+    }
+
+    if (y.is_zero())
+    {
+        return x;
+    }
+    if (x.limbs.size() > 2)
+    {
+        x %= y;
+    }
+
+    BigInteger result;
+    result.assignNative(binaryGcd(x.toNative(), y.toNative()), false);
+    return result;
+}
+
+inline BigInteger BigInteger::lcm(const BigInteger& a, const BigInteger& b)
+{
+    if (a.is_zero() || b.is_zero())
+    {
+        return BigInteger(0);
+    }
+
+    BigInteger result = a.divexact(gcd(a, b)) * b;
+    result.negative = false;
+    return result;
+}
+
+inline std::tuple<BigInteger, BigInteger, BigInteger> BigInteger::extended_gcd(const BigInteger& a, const BigInteger& b)
+{
+    // {g, x, y} with a * x + b * y = g = gcd(a, b)
+    // lehmer steps on the leading bits as in gcd, applied to the cofactors alongside
+    BigInteger r0 = a.negative ? -a : a;
+    BigInteger r1 = b.negative ? -b : b;
+    BigInteger s0(1);
+    BigInteger s1(0);
+    BigInteger t0(0);
+    BigInteger t1(1);
+    if (compareLimbs(r0.limbs.data(), r0.limbs.size(), r1.limbs.data(), r1.limbs.size()) < 0)
+    {
+        std::swap(r0, r1);
+        std::swap(s0, s1);
+        std::swap(t0, t1);
+    }
+
+    while (!r1.is_zero())
+    {
+        std::array<int64_t, 4> cofactors;
+        if (r1.limbs.size() > 2 && (cofactors = lehmerCofactors(r0, r1))[1] != 0)
+        {
+            lehmerUpdate(r0, r1, cofactors);
+            lehmerUpdateCoefficients(s0, s1, cofactors);
+            lehmerUpdateCoefficients(t0, t1, cofactors);
+            continue;
+        }
+
+        auto [q, r] = r0.divmod(r1);
+        r0 = std::move(r1);
+        r1 = std::move(r);
+
+        BigInteger s = s0 - q * s1;
+        s0 = std::move(s1);
+        s1 = std::move(s);
+
+        BigInteger t = t0 - q * t1;
+        t0 = std::move(t1);
+        t1 = std::move(t);
+    }
+
+    if (a.negative)
+    {
+        s0 = -std::move(s0);
+    }
+    if (b.negative)
+    {
+        t0 = -std::move(t0);
+    }
+
+    return {std::move(r0), std::move(s0), std::move(t0)};
+}
+
+inline BigInteger BigInteger::mod_inverse(const BigInteger& a, const BigInteger& modulus)
+{
+    // x in [0, |modulus|) with a * x = 1 (mod modulus), only the coefficient of a is tracked
+    if (modulus.is_zero())
+    {
+        throw std::invalid_argument("zero modulus");
+    }
+
+    BigInteger m = modulus.negative ? -modulus : modulus;
+    BigInteger r0 = m;
+    BigInteger r1 = a % m;
+    if (r1.negative)
+    {
+        r1 += m;
+    }
+
+    BigInteger t0(0);
+    BigInteger t1(1);
+
+    while (!r1.is_zero())
+    {
+        std::array<int64_t, 4> cofactors;
+        if (r1.limbs.size() > 2 && (cofactors = lehmerCofactors(r0, r1))[1] != 0)
+        {
+            lehmerUpdate(r0, r1, cofactors);
+            lehmerUpdateCoefficients(t0, t1, cofactors);
+            continue;
+        }
+
+        auto [q, r] = r0.divmod(r1);
+        r0 = std::move(r1);
+        r1 = std::move(r);
+
+        BigInteger t = t0 - q * t1;
+        t0 = std::move(t1);
+        t1 = std::move(t);
+    }
+
+    if (!r0.is_one())
+    {
+        throw std::domain_error("not invertible");
+    }
+
+    if (t0.negative)
+    {
+        t0 += m;
+    }
+    return t0;
+}
+
+inline BigInteger BigInteger::crt(const std::vector<BigInteger>& residues, const std::vector<BigInteger>& moduli)
+{
+    // x in [0, M), M = m_1 * ... * m_n, with x = r_i (mod m_i) for pairwise coprime m_i > 0:
+    // x = sum c_i * M / m_i with c_i = r_i * (M / m_i)^-1 mod m_i (von zur Gathen, Gerhard,
+    // "Modern Computer Algebra", 10.3), every M / m_i mod m_i comes from one remainder tree
+    if (residues.size() != moduli.size() || moduli.empty())
+    {
+        throw std::invalid_argument("crt sizes");
+    }
+
+    for (const BigInteger& modulus : moduli)
+    {
+        if (modulus.sign() <= 0)
+        {
+            throw std::invalid_argument("crt modulus");
+        }
+    }
+
+    std::vector<std::vector<BigInteger>> tree = productTree(moduli);
+    const BigInteger& product = tree.back()[0];
+
+    // M mod m^2 for every node m going down, so that (M mod m_i^2) / m_i = (M / m_i) mod m_i
+    std::vector<BigInteger> remainders = {product};
+    for (size_t level = tree.size() - 1; level-- > 0;)
+    {
+        std::vector<BigInteger> next(tree[level].size());
+        for (size_t i = 0; i < next.size(); i++)
+        {
+            next[i] = remainders[i / 2] % tree[level][i].square();
+        }
+        remainders = std::move(next);
+    }
+
+    std::vector<BigInteger> values(moduli.size());
+    for (size_t i = 0; i < moduli.size(); i++)
+    {
+        BigInteger cofactor = remainders[i].divexact(moduli[i]);
+        values[i] = residues[i] * mod_inverse(cofactor, moduli[i]) % moduli[i];
+    }
+
+    // combine going up: a node holds sum c_i * (its product / m_i)
+    for (size_t level = 0; level + 1 < tree.size(); level++)
+    {
+        std::vector<BigInteger> next((values.size() + 1) / 2);
+        for (size_t j = 0; j < next.size(); j++)
+        {
+            if (2 * j + 1 < values.size())
+            {
+                next[j] = values[2 * j] * tree[level][2 * j + 1] + values[2 * j + 1] * tree[level][2 * j];
+            }
+            else
+            {
+                next[j] = std::move(values[2 * j]);
+            }
+        }
+        values = std::move(next);
+    }
+
+    BigInteger result = values[0] % product;
+    if (result.negative)
+    {
+        result += product;
+    }
+    return result;
+}
+
+#if SUPPORT_MORE_OPS == 1
+
+inline BigInteger BigInteger::isqrt() const
+{
+    return sqrtrem().first;
+}
+
+inline std::pair<BigInteger, BigInteger> BigInteger::sqrtrem() const
+{
+    if (negative)
+    {
+        throw std::runtime_error("negative number");
+    }
+
+    BigInteger remainder;
+    BigInteger root = sqrtRemainder(*this, remainder);
+    return {std::move(root), std::move(remainder)};
+}
+
+inline BigInteger BigInteger::iroot(uint64_t k) const
+{
+    if (k == 0)
+    {
+        throw std::invalid_argument("zero root");
+    }
+
+    if (negative && k % 2 == 0)
+    {
+        throw std::runtime_error("negative number");
+    }
+
+    if (k == 1 || is_zero())
+    {
+        return *this;
+    }
+
+    BigInteger magnitude = negative ? -*this : *this;
+    BigInteger remainder;
+    BigInteger root = k == 2 ? sqrtRemainder(magnitude, remainder) : rootNewton(magnitude, k);
+    return negative ? -root : root;
+}
+
+inline bool BigInteger::is_perfect_power() const
+{
+    // 0, 1 and -1 are powers of themselves; a negative number needs an odd exponent
+    BigInteger magnitude = negative ? -*this : *this;
+    if (magnitude.compareSmall(1, false) <= 0)
+    {
+        return true;
+    }
+
+    // a power is a power with a prime exponent too, and m^k has k times the trailing zeros of m;
+    // m >= 2 bounds the exponent by the bit length
+    size_t bits = magnitude.bit_length();
+    size_t zeros = magnitude.trailing_zeros();
+    std::vector<bool> composite(bits + 1);
+
+    for (size_t k = 2; k < bits; ++k)
+    {
+        if (composite[k])
+        {
+            continue;
+        }
+
+        for (size_t multiple = k * k; multiple < bits; multiple += k)
+        {
+            composite[multiple] = true;
+        }
+
+        if ((negative && k == 2) || (zeros != 0 && zeros % k != 0))
+        {
+            continue;
+        }
+
+        // a k-th power is a k-th power residue modulo each prime q = jk + 1, which only one in k
+        // residues is, so a few such primes reject nearly all other numbers before any root is taken
+        bool residue = true;
+        for (uint64_t q = 2 * k + 1, tried = 0; residue && tried < 4; q += 2 * k)
+        {
+            bool prime = true;
+            for (uint64_t d = 3; d * d <= q && prime; d += 2)
+            {
+                prime = q % d != 0;
+            }
+            if (prime)
+            {
+                uint64_t r = magnitude.moduloSmall(q);
+                residue = r == 0 || powerModulo(r, (q - 1) / k, q) == 1;
+                ++tried;
+            }
+        }
+
+        if (residue && pow(magnitude.iroot(k), k) == magnitude)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline bool BigInteger::is_prime(size_t k) const {
+    if (*this <= 1)
+    {
+        return false;
+    }
+
+    if (*this == 2 || *this == 3)
+    {
+        return true;
+    }
+
+    if (is_even())
+    {
+        return false;
+    }
+
+    BigInteger n_minus_one = *this - 1;
+    size_t s = n_minus_one.trailing_zeros();
+    BigInteger d = n_minus_one >> s;
+
+    // the witnesses are checked in Montgomery form, 1 and n - 1 are converted once
+    MontgomeryContext context(*this);
+    BigInteger minus_one = context.to_montgomery(n_minus_one);
+
+    for (size_t i = 0; i < k; i++)
+    {
+        BigInteger a = randomRange(2, *this - 2);
+        BigInteger x = context.power(context.to_montgomery(a), d);
+
+        if (x == context.one() || x == minus_one)
+        {
+            continue;
+        }
+
+        bool is_composite = true;
+
+        for (size_t r = 1; r < s; r++)
+        {
+            x = context.square(x);
+            if (x == minus_one)
+            {
+                is_composite = false;
+                break;
+            }
+        }
+
+        if (is_composite) return false;
+    }
+
+    return true;
+}
+
+#endif
+
+#if SUPPORT_EVAL == 1
+
+inline std::string removeSpaces(const std::string& string)  // string = "{ \"op\" : \"+\", \"left\" : 123, \"right\" : 456 }"
+{
+    std::string result;
+
+    for (char ch : string)
+    {
+        if (!std::isspace(ch))
+        {
+            result += ch;
+        }
+    }
+    return result;  // result = "{\"op\":\"+\",\"left\":123,\"right\":456}"
+}
+
+
+inline std::string findValue(const std::string& json, const std::string& key, size_t& pos)
+{
+    size_t key_pos = json.find("\"" + key + "\":", pos);
+
+    if (key_pos == std::string::npos)
+    {
+        throw std::invalid_argument(key);
+    }
+
+    size_t value_pos = key_pos + key.length() + 3;
+
+    if (json[value_pos] == '{')
+    {
+        // object
+        size_t brace_count = 1;
+        size_t end_pos = value_pos + 1;
+        while (brace_count > 0 && end_pos < json.length())
+        {
+            if (json[end_pos] == '{')
+            {
+                brace_count += 1;
+            }
+            else if (json[end_pos] == '}')
+            {
+                brace_count-=1;
+            }
+            end_pos+=1;
+        }
+        if (brace_count != 0)
+        {
+            throw std::invalid_argument("end brace");
+        }
+
+        pos = end_pos;
+        return json.substr(value_pos, end_pos - value_pos);
+    }
+    else if (json[value_pos] == '"')
+    {
+        // string
+        size_t end_pos = json.find('"', value_pos + 1);
+
+        if (end_pos == std::string::npos)
+        {
+            throw std::invalid_argument("end quotation mark");
+        }
+
+        pos = end_pos + 1;
+        return json.substr(value_pos + 1, end_pos - value_pos - 1);
+    }
+    else
+    {
+        // number
+        size_t end_pos = value_pos;
+        while (end_pos < json.length() && (std::isdigit(json[end_pos]) || json[end_pos] == '-' || json[end_pos] == '.'))
+        {
+            end_pos +=1 ;
+        }
+
+        pos = end_pos;
+        return json.substr(value_pos, end_pos - value_pos);
+    }
+}
+
+inline BigInteger evaluate(const std::string& json)
+{
+    std::string json_format = removeSpaces(json);
+
+    if (json_format.empty())
+    {
+        throw std::invalid_argument("empty json");
+    }
+
+    if (json_format[0] != '{')
+    {
+        // string or number
+        if (json_format[0] == '"')
+        {
+            // string
+            if (json_format.back() != '"')
+            {
+                throw std::invalid_argument("end string");
+            }
+
+            std::string value = json_format.substr(1, json_format.length() - 2);
+            return BigInteger(value);
+        }
+        else
+        {
+            // number
+            size_t dot_pos = json_format.find('.'); // remove decimal part
+
+            std::string integer_part = (dot_pos == std::string::npos) ? json_format : json_format.substr(0, dot_pos);
+            return BigInteger(integer_part);
+        }
+    }
+    // object with "op", "left", "rigth" in {}
+
+    size_t pos = 1;
+
+    // op
+    std::string op = findValue(json_format, "op", pos);
+
+    // left
+    std::string left_str = findValue(json_format, "left", pos);
+    BigInteger left_value = evaluate(left_str);
+
+    // right
+    std::string right_str = findValue(json_format, "right", pos);
+    BigInteger right_value = evaluate(right_str);
+
+    if (op == "+")
+    {
+        return left_value + right_value;
+    }
+    else if (op == "-")
+    {
+        return left_value - right_value;
+    }
+    else if (op == "*")
+    {
+        return left_value * right_value;
+    }
+    else if (op == "/")
+    {
+        return left_value / right_value;
+    }
+    else if (op == "%")
+    {
+        return left_value % right_value;
+    }
+    else
+    {
+        throw std::invalid_argument("unknown operator");
+    }
+}
+
+
+inline BigInteger eval(const std::string& input)
+{
+    return evaluate(input);
+}
+
+#endif
+
+/* Assistants */
+
+inline void BigInteger::removeLeadingZeros()
+{
+    while (!limbs.empty() && limbs.back() == 0)
+    {
+        limbs.pop_back();
+    }
+
+    if (limbs.empty())
+    {
+        negative = false;
+    }
+}
+
+inline BigInteger::uint128 BigInteger::toNative() const
+{
+    // magnitude of a value of at most two limbs
+    uint128 magnitude = 0;
+    for (size_t i = limbs.size(); i-- > 0;)
+    {
+        magnitude = (magnitude << 64) | limbs[i];
+    }
+    return magnitude;
+}
+
+inline void BigInteger::assignNative(uint128 magnitude, bool is_negative)
+{
+    limbs.clear();
+    while (magnitude != 0)
+    {
+        limbs.push_back(static_cast<uint64_t>(magnitude));
+        magnitude >>= 64;
+    }
+    negative = is_negative && !limbs.empty();
+}
+
+inline void BigInteger::appendDigits(std::string& result, const BigInteger& x, size_t width, int base)
+{
+    // x >= 0 with at least width digits, zero padded
+    static constexpr char symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    size_t size = x.limbs.size();
+    size_t digit_count = 0;
+    if (std::has_single_bit(static_cast<unsigned>(base)))
+    {
+        // every digit is a run of bits
+        size_t bits = std::countr_zero(static_cast<unsigned>(base));
+        digit_count = (x.bit_length() + bits - 1) / bits;
+        result.append(width > digit_count ? width - digit_count : 0, '0');
+        size_t end = result.size() + digit_count;
+        result.resize(end);
+        for (size_t i = 0; i < digit_count; i++)
+        {
+            result[--end] = symbols[x.bitsFrom(i * bits) & (base - 1)];
+        }
+        return;
+    }
+
+    auto [chunk_base, chunk_digits] = radixChunk(base);
+
+    if (size >= std::max<size_t>(radix_threshold, 2))
+    {
+        // split at a power of about half the size into a quotient and a remainder with exactly
+        // the digits of the power
+        size_t k = std::bit_width(size / 2) - 1;
+        size_t low_width = chunk_digits << k;
+        auto [quotient, remainder] = x.divmod(radixPower(base, k));
+        appendDigits(result, quotient, width > low_width ? width - low_width : 0, base);
+        appendDigits(result, remainder, low_width, base);
+        return;
+    }
+
+    // chunks of chunk_digits digits by single limb divisions, least significant first
+    Limbs temp = x.limbs;
+    std::vector<uint64_t> chunks;
+
+    while (size > 0)
+    {
+        chunks.push_back(divideLimb(temp.data(), temp.data(), size, chunk_base));
+        while (size > 0 && temp[size - 1] == 0)
+        {
+            size--;
+        }
+    }
+
+    // all chunks but the leading one have exactly chunk_digits digits
+    size_t leading_digits = 0;
+    for (uint64_t chunk = chunks.empty() ? 0 : chunks.back(); chunk != 0; chunk /= base)
+    {
+        leading_digits++;
+    }
+    digit_count = chunks.empty() ? 0 : (chunks.size() - 1) * chunk_digits + leading_digits;
+    result.append(width > digit_count ? width - digit_count : 0, '0');
+
+    // a constant radix lets decimal digits divide by multiplications
+    size_t end = result.size() + digit_count;
+    result.resize(end);
+    auto write = [&](auto radix)
+    {
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            uint64_t chunk = chunks[i];
+            for (size_t j = i + 1 < chunks.size() ? chunk_digits : leading_digits; j > 0; j--)
+            {
+                result[--end] = symbols[chunk % radix];
+                chunk /= radix;
+            }
+        }
+    };
+
+    if (base == 10)
+    {
+        write(std::integral_constant<uint64_t, 10>());
+    }
+    else
+    {
+        write(static_cast<uint64_t>(base));
+    }
+}
+
+inline BigInteger BigInteger::parseDigits(const std::string& digits, size_t from, size_t to, int base)
+{
+    // the digits [from, to), already validated
+    BigInteger result;
+    Limbs& limbs = result.limbs;
+
+    if (std::has_single_bit(static_cast<unsigned>(base)))
+    {
+        // every digit is a run of bits, or'ed in from the least significant one
+        size_t bits = std::countr_zero(static_cast<unsigned>(base));
+        limbs.resize(((to - from) * bits + 63) / 64);
+        for (size_t i = to, position = 0; i-- > from; position += bits)
+        {
+            uint64_t value = static_cast<uint64_t>(digitValue(digits[i]));
+            limbs[position / 64] |= value << (position % 64);
+            if (position % 64 + bits > 64)
+            {
+                limbs[position / 64 + 1] |= value >> (64 - position % 64);
+            }
+        }
+        result.removeLeadingZeros();
+        return result;
+    }
+
+    auto [chunk_base, chunk_digits] = radixChunk(base);
+
+    size_t chunk_count = (to - from) / chunk_digits;
+    if (chunk_count >= std::max<size_t>(radix_threshold, 2))
+    {
+        // split at a power of about half the length
+        size_t k = std::bit_width(chunk_count / 2) - 1;
+        size_t low_width = chunk_digits << k;
+        result = parseDigits(digits, from, to - low_width, base) * radixPower(base, k);
+        result += parseDigits(digits, to - low_width, to, base);
+        return result;
+    }
+
+    limbs.reserve(chunk_count + 1);
+
+    // the first chunk takes the remainder so that all others are exactly chunk_digits digits
+    size_t chunk_size = (to - from) % chunk_digits;
+    if (chunk_size == 0)
+    {
+        chunk_size = chunk_digits;
+    }
+
+    for (size_t pos = from; pos < to;)
+    {
+        uint64_t chunk = 0;
+        uint64_t scale = 1;
+
+        for (size_t i = 0; i < chunk_size; i++)
+        {
+            chunk = chunk * base + digitValue(digits[pos + i]);
+            scale *= base;
+        }
+
+        // limbs = limbs * scale + chunk
+        uint64_t carry = multiplyLimb(limbs.data(), limbs.data(), limbs.size(), scale);
+        for (size_t i = 0; i < limbs.size() && chunk != 0; i++)
+        {
+            limbs[i] += chunk;
+            chunk = limbs[i] < chunk;
+        }
+        if (carry != 0 || chunk != 0)
+        {
+            limbs.push_back(carry + chunk);
+        }
+
+        pos += chunk_size;
+        chunk_size = chunk_digits;
+    }
+
+    return result;
+}
+
+inline const BigInteger& BigInteger::radixPower(int base, size_t k)
+{
+    // base^(chunk digits * 2^k), squared up on demand and shared by all conversions; a deque keeps
+    // the references handed out valid while it grows
+    static std::array<std::deque<BigInteger>, 37> powers;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::deque<BigInteger>& table = powers[base];
+    if (table.empty())
+    {
+        BigInteger chunk_power;
+        chunk_power.assignNative(radixChunk(base).first, false);
+        table.push_back(std::move(chunk_power));
+    }
+    while (table.size() <= k)
+    {
+        table.push_back(table.back().square());
+    }
+    return table[k];
+}
+
+constexpr std::pair<uint64_t, size_t> BigInteger::radixChunk(int base)
+{
+    // the largest power of the base in a limb and its number of digits, 10^19 for decimal
+    uint64_t power = static_cast<uint64_t>(base);
+    size_t digits = 1;
+    while (power <= UINT64_MAX / static_cast<uint64_t>(base))
+    {
+        power *= static_cast<uint64_t>(base);
+        digits++;
+    }
+    return {power, digits};
+}
+
+constexpr int BigInteger::digitValue(int c)
+{
+    // 0 to 35 for a digit or letter, 36 otherwise
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'z')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'Z')
+    {
+        return c - 'A' + 10;
+    }
+    return 36;
+}
+
+inline int BigInteger::compareLimbs(const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    if (a_size != b_size)
+    {
+        return a_size < b_size ? -1 : 1;
+    }
+
+    for (size_t i = a_size; i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+inline uint64_t BigInteger::addLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // requires a_size >= b_size, result may alias a or b
+    uint64_t carry = 0;
+    size_t i = 0;
+
+    for (; i < b_size; i++)
+    {
+        uint64_t sum = a[i] + carry;
+        carry = sum < carry;
+        sum += b[i];
+        carry += sum < b[i];
+        result[i] = sum;
+    }
+
+    for (; i < a_size; i++)
+    {
+        result[i] = a[i] + carry;
+        carry = result[i] < carry;
+    }
+
+    return carry;
+}
+
+inline uint64_t BigInteger::subtractLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // requires a_size >= b_size, result may alias a or b
+    uint64_t borrow = 0;
+    size_t i = 0;
+
+    for (; i < b_size; i++)
+    {
+        uint64_t x = a[i];
+        uint64_t y = b[i];
+        result[i] = x - y - borrow;
+        borrow = (x < y) || (x - y < borrow);
+    }
+
+    for (; i < a_size; i++)
+    {
+        uint64_t x = a[i];
+        result[i] = x - borrow;
+        borrow = x < borrow;
+    }
+
+    return borrow;
+}
+
+inline uint64_t BigInteger::multiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m)
+{
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint128 product = static_cast<uint128>(a[i]) * m + carry;
+        result[i] = static_cast<uint64_t>(product);
+        carry = static_cast<uint64_t>(product >> 64);
+    }
+
+    return carry;
+}
+
+inline uint64_t BigInteger::addMultiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m)
+{
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint128 product = static_cast<uint128>(a[i]) * m + result[i] + carry;
+        result[i] = static_cast<uint64_t>(product);
+        carry = static_cast<uint64_t>(product >> 64);
+    }
+
+    return carry;
+}
+
+inline uint64_t BigInteger::subtractMultiplyLimb(uint64_t* result, const uint64_t* a, size_t size, uint64_t m)
+{
+    uint64_t borrow = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint128 product = static_cast<uint128>(a[i]) * m + borrow;
+        uint64_t low = static_cast<uint64_t>(product);
+        borrow = static_cast<uint64_t>(product >> 64);
+
+        uint64_t x = result[i];
+        result[i] = x - low;
+        borrow += x < low;
+    }
+
+    return borrow;
+}
+
+inline void BigInteger::divideExactLimbs(uint64_t* quotient, uint64_t* a, size_t quotient_size, const uint64_t* d, size_t d_size)
+{
+    // quotient of an exact division by an odd d of at least two limbs, from the least significant end;
+    // a is overwritten, and of every q_i * d only the part below quotient_size is subtracted
+    uint64_t inverse = inverseLimb(d[0]);
+
+    for (size_t i = 0; i < quotient_size; i++)
+    {
+        uint64_t q = a[i] * inverse;
+        quotient[i] = q;
+
+        size_t count = std::min(d_size, quotient_size - i);
+        uint64_t borrow = subtractMultiplyLimb(a + i, d, count, q);
+        for (size_t j = i + count; borrow != 0 && j < quotient_size; j++)
+        {
+            uint64_t x = a[j];
+            a[j] = x - borrow;
+            borrow = x < borrow;
+        }
+    }
+}
+
+inline uint64_t BigInteger::divideLimb(uint64_t* quotient, const uint64_t* a, size_t size, uint64_t d)
+{
+    uint64_t remainder = 0;
+
+    for (size_t i = size; i-- > 0;)
+    {
+        uint128 current = (static_cast<uint128>(remainder) << 64) | a[i];
+        quotient[i] = static_cast<uint64_t>(current / d);
+        remainder = static_cast<uint64_t>(current % d);
+    }
+
+    return remainder;
+}
+
+inline void BigInteger::divideKnuth(uint64_t* quotient, uint64_t* remainder, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // Knuth, TAOCP vol. 2, 4.3.1, Algorithm D
+    // requires a_size >= b_size >= 2 and a normalized b; quotient has a_size - b_size + 1 limbs, remainder b_size limbs
+    size_t n = b_size;
+    int shift = std::countl_zero(b[n - 1]);
+
+    // D1: normalize so that the top bit of the divisor is set
+    Limbs u(a_size + 1);
+    Limbs v(n);
+
+    for (size_t i = n - 1; i > 0; i--)
+    {
+        v[i] = shift == 0 ? b[i] : (b[i] << shift) | (b[i - 1] >> (64 - shift));
+    }
+    v[0] = b[0] << shift;
+
+    u[a_size] = shift == 0 ? 0 : a[a_size - 1] >> (64 - shift);
+    for (size_t i = a_size - 1; i > 0; i--)
+    {
+        u[i] = shift == 0 ? a[i] : (a[i] << shift) | (a[i - 1] >> (64 - shift));
+    }
+    u[0] = a[0] << shift;
+
+    for (size_t j = a_size - n + 1; j-- > 0;)
+    {
+        // D3: estimate the quotient limb from the top two limbs, correct with the third
+        uint128 numerator = (static_cast<uint128>(u[j + n]) << 64) | u[j + n - 1];
+        uint128 q_hat = numerator / v[n - 1];
+        uint128 r_hat = numerator % v[n - 1];
+
+        while ((q_hat >> 64) != 0 || q_hat * v[n - 2] > ((r_hat << 64) | u[j + n - 2]))
+        {
+            q_hat--;
+            r_hat += v[n - 1];
+            if ((r_hat >> 64) != 0)
+            {
+                break;
+            }
+        }
+
+        // D4: multiply and subtract, D6: add back in the rare case q_hat was still one too large
+        uint64_t q = static_cast<uint64_t>(q_hat);
+        uint64_t borrow = subtractMultiplyLimb(u.data() + j, v.data(), n, q);
+        uint64_t top = u[j + n];
+        u[j + n] = top - borrow;
+
+        if (top < borrow)
+        {
+            q--;
+            u[j + n] += addLimbs(u.data() + j, u.data() + j, n, v.data(), n);
+        }
+
+        quotient[j] = q;
+    }
+
+    // D8: unnormalize the remainder
+    for (size_t i = 0; i < n; i++)
+    {
+        remainder[i] = shift == 0 ? u[i] : (u[i] >> shift) | (u[i + 1] << (64 - shift));
+    }
+}
+
+inline void BigInteger::multiplySchoolbook(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // result has a_size + b_size limbs and must not alias a or b
+    std::fill(result, result + a_size, 0);
+
+    for (size_t j = 0; j < b_size; j++)
+    {
+        result[a_size + j] = addMultiplyLimb(result + j, a, a_size, b[j]);
+    }
+}
+
+inline void BigInteger::multiplyLow(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t count)
+{
+    // the low count limbs of a * b, exactly; result must not alias a or b
+    std::fill(result, result + count, 0);
+
+    for (size_t j = 0; j < std::min(b_size, count); j++)
+    {
+        size_t length = std::min(a_size, count - j);
+        uint64_t carry = addMultiplyLimb(result + j, a, length, b[j]);
+        if (j + length < count)
+        {
+            result[j + length] = carry;
+        }
+    }
+}
+
+inline void BigInteger::multiplyHigh(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t from)
+{
+    // the limbs [from, a_size + b_size) of a * b with the partial products below column from
+    // left out, so the result is low by less than a_size + b_size units; result has
+    // a_size + b_size - from limbs and must not alias a or b
+    std::fill(result, result + (a_size + b_size - from), 0);
+
+    for (size_t j = 0; j < b_size; j++)
+    {
+        if (j + a_size <= from)
+        {
+            continue;
+        }
+
+        size_t start = from > j ? from - j : 0;
+        uint64_t carry = addMultiplyLimb(result + (start + j - from), a + start, a_size - start, b[j]);
+        result[j + a_size - from] = carry;
+    }
+}
+
+inline void BigInteger::multiplyLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // requires a_size >= b_size, result has a_size + b_size limbs and must not alias a or b
+    if (a == b && a_size == b_size)
+    {
+        squareLimbs(result, a, a_size);
+    }
+    else if (b_size < std::max<size_t>(karatsuba_threshold, 2))
+    {
+        multiplySchoolbook(result, a, a_size, b, b_size);
+    }
+    else if (2 * b_size <= a_size)
+    {
+        multiplyUnbalanced(result, a, a_size, b, b_size);
+    }
+    else if (b_size < toom3_threshold)
+    {
+        multiplyKaratsuba(result, a, a_size, b, b_size);
+    }
+    else if (b_size < toom4_threshold)
+    {
+        multiplyToomCook(result, a, a_size, b, b_size, 3);
+    }
+    else if (b_size < ntt_threshold || a_size + b_size > (size_t(1) << 22))
+    {
+        // products beyond the NTT length limit are split by Toom-4 first
+        multiplyToomCook(result, a, a_size, b, b_size, 4);
+    }
+    else
+    {
+        multiplyNtt(result, a, a_size, b, b_size);
+    }
+}
+
+inline void BigInteger::multiplyUnbalanced(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // cut the longer operand into b_size chunks so that every partial product is balanced
+    std::fill(result, result + a_size + b_size, 0);
+
+    Limbs partial(2 * b_size);
+
+    for (size_t offset = 0; offset < a_size; offset += b_size)
+    {
+        size_t chunk = std::min(b_size, a_size - offset);
+
+        if (chunk == b_size)
+        {
+            multiplyLimbs(partial.data(), a + offset, chunk, b, b_size);
+        }
+        else
+        {
+            multiplyLimbs(partial.data(), b, b_size, a + offset, chunk);
+        }
+
+        accumulateLimbs(result + offset, a_size + b_size - offset, partial.data(), chunk + b_size);
+    }
+}
+
+inline void BigInteger::multiplyKaratsuba(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // a = a1 * B^h + a0, b = b1 * B^h + b0, requires a_size >= b_size > a_size / 2
+    // a * b = z2 * B^2h + (z0 + z2 - (a1 - a0)(b1 - b0)) * B^h + z0
+    size_t h = a_size / 2;
+    size_t a1_size = a_size - h;
+    size_t b1_size = b_size - h;
+
+    multiplyLimbs(result, a, h, b, h);                                  // z0
+    multiplyLimbs(result + 2 * h, a + h, a1_size, b + h, b1_size);      // z2
+
+    size_t db_size = std::max(h, b1_size);
+    Limbs da(a1_size);
+    Limbs db(db_size);
+    bool da_negative = differenceLimbs(da.data(), a + h, a1_size, a, h);
+    bool db_negative = b1_size >= h
+        ? differenceLimbs(db.data(), b + h, b1_size, b, h)
+        : !differenceLimbs(db.data(), b, h, b + h, b1_size);
+
+    Limbs middle(a1_size + db_size);
+    multiplyLimbs(middle.data(), da.data(), a1_size, db.data(), db_size);
+
+    // z1 = z0 + z2 -/+ middle, always non-negative
+    size_t z2_size = a1_size + b1_size;
+    Limbs z1(std::max(2 * h, z2_size) + 1, 0);
+    std::copy(result + 2 * h, result + 2 * h + z2_size, z1.begin());
+    accumulateLimbs(z1.data(), z1.size(), result, 2 * h);
+
+    if (da_negative == db_negative)
+    {
+        subtractLimbs(z1.data(), z1.data(), z1.size(), middle.data(), middle.size());
+    }
+    else
+    {
+        accumulateLimbs(z1.data(), z1.size(), middle.data(), middle.size());
+    }
+
+    accumulateLimbs(result + h, a_size + b_size - h, z1.data(), z1.size());
+}
+
+inline void BigInteger::squareSchoolbook(uint64_t* result, const uint64_t* a, size_t size)
+{
+    // result has 2 * size limbs and must not alias a; each cross product a_i * a_j (i < j)
+    // is computed once and doubled, then the squares a_i^2 are added on the diagonal
+    std::fill(result, result + 2 * size, 0);
+
+    for (size_t i = 0; i + 1 < size; i++)
+    {
+        result[i + size] = addMultiplyLimb(result + 2 * i + 1, a + i + 1, size - i - 1, a[i]);
+    }
+
+    for (size_t i = 2 * size - 1; i > 0; i--)
+    {
+        result[i] = (result[i] << 1) | (result[i - 1] >> 63);
+    }
+    result[0] <<= 1;
+
+    uint64_t carry = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        uint128 square = static_cast<uint128>(a[i]) * a[i];
+
+        uint128 low = static_cast<uint128>(result[2 * i]) + static_cast<uint64_t>(square) + carry;
+        result[2 * i] = static_cast<uint64_t>(low);
+
+        uint128 high = static_cast<uint128>(result[2 * i + 1]) + static_cast<uint64_t>(square >> 64) + static_cast<uint64_t>(low >> 64);
+        result[2 * i + 1] = static_cast<uint64_t>(high);
+        carry = static_cast<uint64_t>(high >> 64);
+    }
+}
+
+inline void BigInteger::squareLimbs(uint64_t* result, const uint64_t* a, size_t size)
+{
+    // the squaring counterpart of multiplyLimbs, on the same thresholds
+    if (size < std::max<size_t>(karatsuba_threshold, 2))
+    {
+        squareSchoolbook(result, a, size);
+    }
+    else if (size < toom3_threshold)
+    {
+        squareKaratsuba(result, a, size);
+    }
+    else if (size < toom4_threshold)
+    {
+        multiplyToomCook(result, a, size, a, size, 3);
+    }
+    else if (size < ntt_threshold || 2 * size > (size_t(1) << 22))
+    {
+        multiplyToomCook(result, a, size, a, size, 4);
+    }
+    else
+    {
+        multiplyNtt(result, a, size, a, size);
+    }
+}
+
+inline void BigInteger::squareKaratsuba(uint64_t* result, const uint64_t* a, size_t size)
+{
+    // a = a1 * B^h + a0, a^2 = z2 * B^2h + (z0 + z2 - (a1 - a0)^2) * B^h + z0,
+    // the middle square is never negative so no sign has to be tracked
+    size_t h = size / 2;
+    size_t a1_size = size - h;
+
+    squareLimbs(result, a, h);                          // z0
+    squareLimbs(result + 2 * h, a + h, a1_size);        // z2
+
+    Limbs difference(a1_size);
+    differenceLimbs(difference.data(), a + h, a1_size, a, h);
+
+    Limbs middle(2 * a1_size);
+    squareLimbs(middle.data(), difference.data(), a1_size);
+
+    // z1 = z0 + z2 - middle
+    Limbs z1(2 * a1_size + 1, 0);
+    std::copy(result + 2 * h, result + 2 * size, z1.begin());
+    accumulateLimbs(z1.data(), z1.size(), result, 2 * h);
+    subtractLimbs(z1.data(), z1.data(), z1.size(), middle.data(), middle.size());
+
+    accumulateLimbs(result + h, 2 * size - h, z1.data(), z1.size());
+}
+
+inline void BigInteger::multiplyToomCook(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size, size_t k)
+{
+    // split into k pieces of h limbs: a(x) = sum a_i * x^i with x = B^h, same for b
+    // evaluate at infinity and at 0, 1, -1, 2, -2, ..., multiply pointwise and
+    // interpolate r(x) = a(x) * b(x) back from divided differences
+    size_t h = (a_size + k - 1) / k;
+    size_t a_pieces = (a_size + h - 1) / h;
+    size_t b_pieces = (b_size + h - 1) / h;
+    size_t degree = a_pieces + b_pieces - 2;
+    bool squaring = (a == b && a_size == b_size);
+
+    std::vector<BigInteger> a_coefficients;
+    std::vector<BigInteger> b_coefficients;
+    for (size_t i = 0; i < a_pieces; i++)
+    {
+        a_coefficients.push_back(fromLimbs(a + i * h, std::min(h, a_size - i * h)));
+    }
+    for (size_t i = 0; i < b_pieces && !squaring; i++)
+    {
+        b_coefficients.push_back(fromLimbs(b + i * h, std::min(h, b_size - i * h)));
+    }
+
+    std::vector<int64_t> points;
+    for (int64_t x = 1; points.size() + 1 < degree; x++)
+    {
+        points.push_back(x);
+        points.push_back(-x);
+    }
+    points.insert(points.begin(), 0);
+    points.resize(degree);
+
+    // r(inf) is the leading coefficient, the remaining degree - 1 polynomial
+    // w(x) = r(x) - r(inf) * x^degree is recovered in Newton form
+    BigInteger leading = squaring ? a_coefficients.back().square() : a_coefficients.back() * b_coefficients.back();
+    std::vector<BigInteger> values(degree);
+
+    for (size_t j = 0; j < degree; j++)
+    {
+        BigInteger a_value = a_coefficients.back();
+        for (size_t i = a_pieces - 1; i-- > 0;)
+        {
+            a_value *= points[j];
+            a_value += a_coefficients[i];
+        }
+
+        // a square needs a single evaluation
+        BigInteger b_value;
+        for (size_t i = squaring ? 0 : b_pieces; i-- > 0;)
+        {
+            b_value *= points[j];
+            b_value += b_coefficients[i];
+        }
+
+        int64_t power = 1;
+        for (size_t i = 0; i < degree; i++)
+        {
+            power *= points[j];
+        }
+
+        BigInteger correction = leading;
+        correction *= power;
+
+        values[j] = squaring ? a_value.square() : a_value * b_value;
+        values[j] -= correction;
+    }
+
+    for (size_t j = 1; j < degree; j++)
+    {
+        for (size_t i = degree - 1; i >= j; i--)
+        {
+            values[i] -= values[i - 1];
+            int64_t difference = points[i] - points[i - j];
+            values[i].divideExactSmall(nativeMagnitude(difference), difference < 0);
+        }
+    }
+
+    // expand the Newton form: w(x) = c0 + (x - x0) * (c1 + (x - x1) * (c2 + ...))
+    std::vector<BigInteger> coefficients(degree + 1);
+    coefficients[degree] = leading;
+    coefficients[0] = values[degree - 1];
+
+    for (size_t i = degree - 1; i-- > 0;)
+    {
+        for (size_t m = degree - 1 - i; m > 0; m--)
+        {
+            BigInteger shifted = coefficients[m];
+            shifted *= points[i];
+            coefficients[m] = coefficients[m - 1] - shifted;
+        }
+        coefficients[0] *= -points[i];
+        coefficients[0] += values[i];
+    }
+
+    size_t result_size = a_size + b_size;
+    std::fill(result, result + result_size, 0);
+
+    for (size_t i = 0; i <= degree; i++)
+    {
+        const Limbs& coefficient = coefficients[i].limbs;
+        accumulateLimbs(result + i * h, result_size - i * h, coefficient.data(), coefficient.size());
+    }
+}
+
+constexpr uint64_t BigInteger::inverseLimb(uint64_t odd)
+{
+    // Newton iteration for odd^-1 mod 2^64, each step doubles the correct low bits
+    uint64_t inverse = odd;     // correct to 3 bits for any odd value
+    for (int i = 0; i < 5; i++)
+    {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+constexpr uint64_t BigInteger::powerModulo(uint64_t base, uint64_t exponent, uint64_t modulus)
+{
+    // word-sized moduli below 2^32 only
+    uint64_t result = 1;
+    base %= modulus;
+
+    while (exponent > 0)
+    {
+        if (exponent & 1)
+        {
+            result = result * base % modulus;
+        }
+        base = base * base % modulus;
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+inline void BigInteger::multiplyNtt(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // number theoretic transform over three primes p = c * 2^k + 1 (k >= 23) with primitive root 3,
+    // operands are cut into 32-bit pieces; every convolution term is below min(a, b) pieces * 2^64,
+    // which stays under p1 * p2 * p3 > 2^86 for transforms up to 2^23 points (a_size + b_size <= 2^22)
+    constexpr uint64_t p1 = 998244353;
+    constexpr uint64_t p2 = 167772161;
+    constexpr uint64_t p3 = 469762049;
+
+    std::vector<uint32_t> a_pieces(2 * a_size);
+    for (size_t i = 0; i < a_size; i++)
+    {
+        a_pieces[2 * i] = static_cast<uint32_t>(a[i]);
+        a_pieces[2 * i + 1] = static_cast<uint32_t>(a[i] >> 32);
+    }
+
+    std::vector<uint32_t> b_pieces;
+    if (a != b || a_size != b_size)
+    {
+        b_pieces.resize(2 * b_size);
+        for (size_t i = 0; i < b_size; i++)
+        {
+            b_pieces[2 * i] = static_cast<uint32_t>(b[i]);
+            b_pieces[2 * i + 1] = static_cast<uint32_t>(b[i] >> 32);
+        }
+    }
+
+    size_t size = std::bit_ceil(2 * (a_size + b_size));
+
+    std::vector<uint32_t> c1 = convolveNtt<p1>(a_pieces, b_pieces, size);
+    std::vector<uint32_t> c2 = convolveNtt<p2>(a_pieces, b_pieces, size);
+    std::vector<uint32_t> c3 = convolveNtt<p3>(a_pieces, b_pieces, size);
+
+    // Garner reconstruction: x = x1 + x2 * p1 + x3 * p1 * p2
+    constexpr uint64_t p1_inverse = powerModulo(p1, p2 - 2, p2);
+    constexpr uint64_t p1p2_inverse = powerModulo(p1 * p2 % p3, p3 - 2, p3);
+
+    uint128 carry = 0;
+
+    for (size_t i = 0; i < a_size + b_size; i++)
+    {
+        uint64_t limb = 0;
+
+        for (size_t half = 0; half < 2; half++)
+        {
+            size_t j = 2 * i + half;
+
+            uint64_t x1 = c1[j];
+            uint64_t x2 = (c2[j] + p2 - x1 % p2) % p2 * p1_inverse % p2;
+            uint64_t x3 = (c3[j] + 2 * p3 - x1 % p3 - x2 * (p1 % p3) % p3) % p3 * p1p2_inverse % p3;
+
+            carry += x1 + static_cast<uint128>(x2) * p1 + static_cast<uint128>(x3) * (p1 * p2);
+            limb |= static_cast<uint64_t>(static_cast<uint32_t>(carry)) << (32 * half);
+            carry >>= 32;
+        }
+
+        result[i] = limb;
+    }
+}
+
+template <uint32_t Modulus>
+inline std::vector<uint32_t> BigInteger::convolveNtt(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, size_t size)
+{
+    // an empty b means squaring a
+    std::vector<uint32_t> fa(size, 0);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        fa[i] = a[i] % Modulus;
+    }
+    transformNtt<Modulus>(fa, false);
+
+    if (b.empty())
+    {
+        for (uint32_t& x : fa)
+        {
+            x = static_cast<uint32_t>(static_cast<uint64_t>(x) * x % Modulus);
+        }
+    }
+    else
+    {
+        std::vector<uint32_t> fb(size, 0);
+        for (size_t i = 0; i < b.size(); i++)
+        {
+            fb[i] = b[i] % Modulus;
+        }
+        transformNtt<Modulus>(fb, false);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * fb[i] % Modulus);
+        }
+    }
+
+    transformNtt<Modulus>(fa, true);
+    return fa;
+}
+
+template <uint32_t Modulus>
+inline void BigInteger::transformNtt(std::vector<uint32_t>& a, bool inverse)
+{
+    // iterative Cooley-Tukey, a.size() is a power of two dividing Modulus - 1
+    size_t size = a.size();
+
+    for (size_t i = 1, j = 0; i < size; i++)
+    {
+        size_t bit = size >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j)
+        {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    std::vector<uint32_t> roots(size / 2);
+
+    for (size_t length = 2; length <= size; length <<= 1)
+    {
+        size_t half = length / 2;
+        uint64_t step = powerModulo(3, (Modulus - 1) / length, Modulus);
+        if (inverse)
+        {
+            step = powerModulo(step, Modulus - 2, Modulus);
+        }
+
+        roots[0] = 1;
+        for (size_t k = 1; k < half; k++)
+        {
+            roots[k] = static_cast<uint32_t>(roots[k - 1] * step % Modulus);
+        }
+
+        for (size_t i = 0; i < size; i += length)
+        {
+            for (size_t k = 0; k < half; k++)
+            {
+                uint32_t u = a[i + k];
+                uint32_t v = static_cast<uint32_t>(static_cast<uint64_t>(a[i + k + half]) * roots[k] % Modulus);
+                a[i + k] = u + v >= Modulus ? u + v - Modulus : u + v;
+                a[i + k + half] = u >= v ? u - v : u + Modulus - v;
+            }
+        }
+    }
+
+    if (inverse)
+    {
+        uint64_t size_inverse = powerModulo(size % Modulus, Modulus - 2, Modulus);
+        for (uint32_t& x : a)
+        {
+            x = static_cast<uint32_t>(x * size_inverse % Modulus);
+        }
+    }
+}
+
+inline bool BigInteger::differenceLimbs(uint64_t* result, const uint64_t* a, size_t a_size, const uint64_t* b, size_t b_size)
+{
+    // result = |a - b| over a_size limbs, requires a_size >= b_size, returns true when a < b
+    size_t a_used = a_size;
+    size_t b_used = b_size;
+    while (a_used > 0 && a[a_used - 1] == 0)
+    {
+        a_used--;
+    }
+    while (b_used > 0 && b[b_used - 1] == 0)
+    {
+        b_used--;
+    }
+
+    if (compareLimbs(a, a_used, b, b_used) >= 0)
+    {
+        subtractLimbs(result, a, a_size, b, b_size);
+        return false;
+    }
+
+    std::fill(result + b_used, result + a_size, 0);
+    subtractLimbs(result, b, b_used, a, a_used);
+    return true;
+}
+
+inline void BigInteger::accumulateLimbs(uint64_t* result, size_t result_size, const uint64_t* a, size_t a_size)
+{
+    // result += a, the sum must fit in result_size limbs
+    while (a_size > 0 && a[a_size - 1] == 0)
+    {
+        a_size--;
+    }
+
+    addLimbs(result, result, result_size, a, a_size);
+}
+
+inline BigInteger BigInteger::fromLimbs(const uint64_t* data, size_t size)
+{
+    BigInteger result;
+    result.limbs.assign(data, data + size);
+    result.removeLeadingZeros();
+    return result;
+}
+
+template <std::integral T>
+inline uint64_t BigInteger::nativeMagnitude(T value)
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "native operands are limited to 64 bits");
+
+    uint64_t bits = static_cast<uint64_t>(value);
+    return std::cmp_less(value, 0) ? 0 - bits : bits;
+}
+
+inline void BigInteger::addSmall(uint64_t magnitude, bool is_negative)
+{
+    // *this += (is_negative ? -magnitude : magnitude)
+    if (magnitude == 0)
+    {
+        return;
+    }
+
+    if (limbs.empty() || negative == is_negative)
+    {
+        negative = is_negative;
+
+        if (limbs.empty())
+        {
+            limbs.push_back(magnitude);
+            return;
+        }
+
+        uint64_t carry = addLimbs(limbs.data(), limbs.data(), limbs.size(), &magnitude, 1);
+        if (carry != 0)
+        {
+            limbs.push_back(carry);
+        }
+        return;
+    }
+
+    if (limbs.size() > 1 || limbs[0] >= magnitude)
+    {
+        subtractLimbs(limbs.data(), limbs.data(), limbs.size(), &magnitude, 1);
+        removeLeadingZeros();
+    }
+    else
+    {
+        limbs[0] = magnitude - limbs[0];
+        negative = is_negative;
+    }
+}
+
+inline void BigInteger::multiplySmall(uint64_t magnitude, bool is_negative)
+{
+    uint64_t carry = multiplyLimb(limbs.data(), limbs.data(), limbs.size(), magnitude);
+    if (carry != 0)
+    {
+        limbs.push_back(carry);
+    }
+
+    negative = (negative != is_negative);
+    removeLeadingZeros();
+}
+
+inline uint64_t BigInteger::divideSmall(uint64_t magnitude, bool is_negative)
+{
+    // truncated division in place, returns the magnitude of the remainder
+    if (magnitude == 0)
+    {
+        throw std::logic_error("zero division");
+    }
+
+    uint64_t remainder = divideLimb(limbs.data(), limbs.data(), limbs.size(), magnitude);
+
+    negative = (negative != is_negative);
+    removeLeadingZeros();
+    return remainder;
+}
+
+inline void BigInteger::divideExactSmall(uint64_t magnitude, bool is_negative)
+{
+    // division in place by a divisor known to leave no remainder, with a multiplication by the
+    // inverse of its odd part per limb instead of a hardware division
+    if (magnitude == 0)
+    {
+        throw std::logic_error("zero division");
+    }
+
+    int shift = std::countr_zero(magnitude);
+    shiftMagnitudeRight(shift);
+    magnitude >>= shift;
+
+    uint64_t inverse = inverseLimb(magnitude);
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < limbs.size(); i++)
+    {
+        uint64_t x = limbs[i];
+        uint64_t q = (x - borrow) * inverse;
+        limbs[i] = q;
+        borrow = static_cast<uint64_t>((static_cast<uint128>(q) * magnitude) >> 64) + (x < borrow);
+    }
+
+    negative = (negative != is_negative);
+    removeLeadingZeros();
+}
+
+inline uint64_t BigInteger::moduloSmall(uint64_t magnitude) const
+{
+    if (magnitude == 0)
+    {
+        throw std::logic_error("zero division");
+    }
+
+    uint64_t remainder = 0;
+    for (size_t i = limbs.size(); i-- > 0;)
+    {
+        remainder = static_cast<uint64_t>(((static_cast<uint128>(remainder) << 64) | limbs[i]) % magnitude);
+    }
+    return remainder;
+}
+
+inline int BigInteger::compareSmall(uint64_t magnitude, bool is_negative) const
+{
+    // sign of *this - (is_negative ? -magnitude : magnitude)
+    if (magnitude == 0)
+    {
+        return sign();
+    }
+
+    if (limbs.empty() || negative != is_negative)
+    {
+        return is_negative ? 1 : -1;
+    }
+
+    int cmp = limbs.size() > 1 ? 1 : (limbs[0] > magnitude) - (limbs[0] < magnitude);
+    return negative ? -cmp : cmp;
+}
+
+template <typename Operation>
+inline void BigInteger::applyBitwise(const BigInteger& rhs, Operation operation)
+{
+    // both operands are streamed as two's complement one limb beyond the longer one,
+    // -m is produced on the fly as ~m + 1; rhs may be *this
+    size_t size = limbs.size();
+    size_t rhs_size = rhs.limbs.size();
+    size_t n = std::max(size, rhs_size) + 1;
+
+    bool result_negative = (operation(negative ? ~0ull : 0ull, rhs.negative ? ~0ull : 0ull) >> 63) != 0;
+
+    uint64_t carry = 1;
+    uint64_t rhs_carry = 1;
+    uint64_t result_carry = 1;
+
+    limbs.resize(n, 0);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t a = limbs[i];
+        if (negative)
+        {
+            a = ~a + carry;
+            carry &= (a == 0);
+        }
+
+        uint64_t b = i < rhs_size ? rhs.limbs[i] : 0;
+        if (rhs.negative)
+        {
+            b = ~b + rhs_carry;
+            rhs_carry &= (b == 0);
+        }
+
+        uint64_t word = operation(a, b);
+        if (result_negative)
+        {
+            word = ~word + result_carry;
+            result_carry &= (word == 0);
+        }
+
+        limbs[i] = word;
+    }
+
+    negative = result_negative;
+    removeLeadingZeros();
+}
+
+inline void BigInteger::addMagnitude(const BigInteger& rhs, bool rhs_negative)
+{
+    // *this += (rhs_negative ? -|rhs| : |rhs|), rhs may be *this
+    size_t size = limbs.size();
+    size_t rhs_size = rhs.limbs.size();
+
+    if (size <= 1 && rhs_size <= 1)
+    {
+        // both magnitudes fit in one limb, so native 128-bit arithmetic is exact
+        uint128 a = toNative();
+        uint128 b = rhs.toNative();
+
+        if (negative == rhs_negative || a == 0)
+        {
+            assignNative(a + b, rhs_negative);
+        }
+        else if (a >= b)
+        {
+            assignNative(a - b, negative);
+        }
+        else
+        {
+            assignNative(b - a, rhs_negative);
+        }
+        return;
+    }
+
+    if (negative == rhs_negative || limbs.empty())
+    {
+        negative = rhs_negative;
+
+        if (size < rhs_size)
+        {
+            limbs.resize(rhs_size, 0);
+        }
+
+        uint64_t carry = addLimbs(limbs.data(), limbs.data(), limbs.size(), rhs.limbs.data(), rhs_size);
+        if (carry != 0)
+        {
+            limbs.push_back(carry);
+        }
+    }
+    else
+    {
+        int cmp = compareLimbs(limbs.data(), size, rhs.limbs.data(), rhs_size);
+
+        if (cmp >= 0)
+        {
+            subtractLimbs(limbs.data(), limbs.data(), size, rhs.limbs.data(), rhs_size);
+        }
+        else
+        {
+            limbs.resize(rhs_size, 0);
+            subtractLimbs(limbs.data(), rhs.limbs.data(), rhs_size, limbs.data(), size);
+            negative = rhs_negative;
+        }
+    }
+
+    removeLeadingZeros();
+}
+
+inline void BigInteger::divisionAndModulus(const BigInteger& rhs, BigInteger& quotient, BigInteger& remainder) const
+{
+    if (rhs.limbs.empty())
+    {
+        throw std::logic_error("zero division");
+    }
+
+    if (compareLimbs(limbs.data(), limbs.size(), rhs.limbs.data(), rhs.limbs.size()) < 0)
+    {
+        remainder = *this;
+        quotient = BigInteger(0);
+        return;
+    }
+
+    size_t size = limbs.size();
+    size_t rhs_size = rhs.limbs.size();
+
+    BigInteger q;
+    BigInteger r;
+
+    if (size <= 2)
+    {
+        // the dividend fits in native 128 bits
+        uint128 a = toNative();
+        uint128 b = rhs.toNative();
+
+        q.assignNative(a / b, negative != rhs.negative);
+        r.assignNative(a % b, negative);
+    }
+    else if (rhs_size >= burnikel_ziegler_threshold && size - rhs_size >= burnikel_ziegler_threshold / 2)
+    {
+        divideBurnikelZiegler(fromLimbs(limbs.data(), size), fromLimbs(rhs.limbs.data(), rhs_size), q, r);
+    }
+    else
+    {
+        q.limbs.resize(size - rhs_size + 1);
+        r.limbs.resize(rhs_size);
+
+        if (rhs_size == 1)
+        {
+            r.limbs[0] = divideLimb(q.limbs.data(), limbs.data(), size, rhs.limbs[0]);
+        }
+        else
+        {
+            divideKnuth(q.limbs.data(), r.limbs.data(), limbs.data(), size, rhs.limbs.data(), rhs_size);
+        }
+    }
+
+    q.negative = (negative != rhs.negative);
+    q.removeLeadingZeros();
+
+    r.negative = negative;
+    r.removeLeadingZeros();
+
+    quotient = std::move(q);
+    remainder = std::move(r);
+}
+
+inline void BigInteger::divideBurnikelZiegler(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder)
+{
+    // Burnikel, Ziegler, "Fast Recursive Division", MPI-I-98-1-022, algorithm 3
+    // a and b are non-negative, the divisor is padded to n = j * 2^k limbs and normalized
+    size_t s = b.limbs.size();
+    size_t m = std::bit_ceil(s / std::max<size_t>(burnikel_ziegler_threshold, 1) + 1);
+    size_t j = (s + m - 1) / m;
+    size_t n = j * m;
+
+    size_t sigma = 64 * n - b.bit_length();
+
+    BigInteger b_shifted = b;
+    b_shifted.shiftMagnitudeLeft(sigma);
+    BigInteger a_shifted = a;
+    a_shifted.shiftMagnitudeLeft(sigma);
+
+    // split the dividend into t blocks of n limbs, the top one with a zero bit to spare
+    size_t t = std::max<size_t>((a_shifted.bit_length() + 64 * n) / (64 * n), 2);
+
+    quotient.limbs.assign((t - 1) * n, 0);
+    quotient.negative = false;
+
+    BigInteger z = a_shifted.sliceLimbs((t - 2) * n, 2 * n);
+
+    for (size_t i = t - 1; i-- > 0;)
+    {
+        BigInteger q;
+        BigInteger r;
+        divideTwoByOne(z, b_shifted, n, q, r);
+
+        std::copy(q.limbs.begin(), q.limbs.end(), quotient.limbs.begin() + i * n);
+
+        if (i > 0)
+        {
+            z = r;
+            z.shiftLimbsLeft(n);
+            z += a_shifted.sliceLimbs((i - 1) * n, n);
+        }
+        else
+        {
+            remainder = r;
+        }
+    }
+
+    quotient.removeLeadingZeros();
+    remainder.shiftMagnitudeRight(sigma);
+}
+
+inline void BigInteger::divideTwoByOne(const BigInteger& a, const BigInteger& b, size_t n, BigInteger& quotient, BigInteger& remainder)
+{
+    // a < b * B^n, b has n limbs with the top bit set
+    if (n % 2 != 0 || n < burnikel_ziegler_threshold)
+    {
+        if (compareLimbs(a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size()) < 0)
+        {
+            quotient = BigInteger(0);
+            remainder = a;
+            return;
+        }
+
+        quotient.limbs.assign(a.limbs.size() - n + 1, 0);
+        remainder.limbs.assign(n, 0);
+
+        if (n == 1)
+        {
+            remainder.limbs[0] = divideLimb(quotient.limbs.data(), a.limbs.data(), a.limbs.size(), b.limbs[0]);
+        }
+        else
+        {
+            divideKnuth(quotient.limbs.data(), remainder.limbs.data(), a.limbs.data(), a.limbs.size(), b.limbs.data(), n);
+        }
+
+        quotient.negative = false;
+        remainder.negative = false;
+        quotient.removeLeadingZeros();
+        remainder.removeLeadingZeros();
+        return;
+    }
+
+    size_t half = n / 2;
+
+    BigInteger q1;
+    BigInteger r;
+    divideThreeByTwo(a.sliceLimbs(half, 3 * half), b, half, q1, r);
+
+    r.shiftLimbsLeft(half);
+    r += a.sliceLimbs(0, half);
+
+    divideThreeByTwo(r, b, half, quotient, remainder);
+
+    q1.shiftLimbsLeft(half);
+    quotient += q1;
+}
+
+inline void BigInteger::divideThreeByTwo(const BigInteger& a, const BigInteger& b, size_t n, BigInteger& quotient, BigInteger& remainder)
+{
+    // a < b * B^n, b = [b1, b2] has 2n limbs with the top bit set
+    BigInteger a12 = a.sliceLimbs(n, 2 * n);
+    BigInteger a1 = a.sliceLimbs(2 * n, n);
+    BigInteger b1 = b.sliceLimbs(n, n);
+    BigInteger b2 = b.sliceLimbs(0, n);
+
+    BigInteger r1;
+
+    if (a1 < b1)
+    {
+        divideTwoByOne(a12, b1, n, quotient, r1);
+    }
+    else
+    {
+        // quotient = B^n - 1, r1 = a12 - quotient * b1
+        quotient.limbs.assign(n, ~uint64_t(0));
+        quotient.negative = false;
+
+        r1 = a12 + b1;
+        b1.shiftLimbsLeft(n);
+        r1 -= b1;
+    }
+
+    r1.shiftLimbsLeft(n);
+    r1 += a.sliceLimbs(0, n);
+    r1 -= quotient * b2;
+
+    while (r1.sign() < 0)
+    {
+        r1 += b;
+        quotient -= 1;
+    }
+
+    remainder = r1;
+}
+
+inline uint64_t BigInteger::bitsFrom(size_t position) const
+{
+    // bits [position, position + 64) of the magnitude
+    size_t index = position / 64;
+    size_t offset = position % 64;
+    if (index >= limbs.size())
+    {
+        return 0;
+    }
+
+    uint64_t bits = limbs[index] >> offset;
+    if (offset != 0 && index + 1 < limbs.size())
+    {
+        bits |= limbs[index + 1] << (64 - offset);
+    }
+    return bits;
+}
+
+template <std::floating_point F>
+inline std::pair<F, int64_t> BigInteger::roundMantissa() const
+{
+    // the leading digits of F, rounded half to even on the next bit and whether any bit below is set
+    constexpr size_t digits = std::numeric_limits<F>::digits;
+    static_assert(digits < 128);
+
+    if (is_zero())
+    {
+        return {F(0), 0};
+    }
+
+    size_t bits = bit_length();
+    size_t shift = bits > digits ? bits - digits : 0;
+    uint128 top = bitsFrom(shift) | static_cast<uint128>(bitsFrom(shift + 64)) << 64;
+    if (shift > 0 && (bitsFrom(shift - 1) & 1) && ((top & 1) || trailing_zeros() < shift - 1))
+    {
+        ++top;
+    }
+
+    // a carry out of the rounding leaves the mantissa at one
+    F mantissa = std::ldexp(static_cast<F>(top), -static_cast<int>(bits - shift));
+    int64_t exponent = static_cast<int64_t>(bits);
+    if (mantissa == F(1))
+    {
+        mantissa = F(0.5);
+        ++exponent;
+    }
+
+    return {negative ? -mantissa : mantissa, exponent};
+}
+
+template <std::floating_point F>
+inline F BigInteger::scaleMantissa(F mantissa, int64_t exponent)
+{
+    // mantissa * 2^exponent, below the normal range ldexp rounds a second time
+    constexpr int64_t limit = std::numeric_limits<F>::max_exponent + 1;
+    F result = std::ldexp(mantissa, static_cast<int>(std::clamp<int64_t>(exponent, std::numeric_limits<int>::min(), limit)));
+    if (std::isinf(result))
+    {
+        throw std::runtime_error("large number");
+    }
+    return result;
+}
+
+inline void BigInteger::appendRecordBody(std::vector<uint8_t>& record) const
+{
+    // sign, LEB128 byte count and little-endian magnitude
+    size_t size = (bit_length() + 7) / 8;
+
+    record.push_back(negative ? 1 : 0);
+    for (uint64_t length = size; ; length >>= 7)
+    {
+        record.push_back(static_cast<uint8_t>((length & 0x7f) | (length >= 0x80 ? 0x80 : 0)));
+        if (length < 0x80)
+        {
+            break;
+        }
+    }
+
+    record.reserve(record.size() + size);
+    for (size_t i = 0; i < size; i++)
+    {
+        record.push_back(static_cast<uint8_t>(limbs[i / 8] >> (8 * (i % 8))));
+    }
+}
+
+template <typename Read>
+inline BigInteger BigInteger::readRecord(Read read)
+{
+    // read(destination, count) throws at the end of the record
+    uint8_t version = 0;
+    read(&version, 1);
+    if (version != record_version)
+    {
+        throw std::invalid_argument("record version");
+    }
+
+    return readRecordBody(read);
+}
+
+template <typename Read>
+inline BigInteger BigInteger::readRecordBody(Read read)
+{
+    // the inverse of appendRecordBody, which accepts the canonical form only
+    uint8_t sign = 0;
+    read(&sign, 1);
 
-        if (!std::isdigit(c))
+    uint64_t length = 0;
+    for (size_t shift = 0; ; shift += 7)
+    {
+        uint8_t byte = 0;
+        read(&byte, 1);
+        if (shift > 56 || (byte == 0 && shift > 0))
+        {
+            throw std::invalid_argument("malformed record");
+        }
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
         {
             break;
         }
+    }
 
-        digits.push_back(static_cast<char>(c));
-        found_digit = true;
-        in.ignore(1);
+    // grown as the bytes arrive, so that a corrupt length cannot allocate more than it reads
+    std::vector<uint8_t> bytes;
+    while (bytes.size() < length)
+    {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(length - bytes.size(), 1 << 16));
+        bytes.resize(bytes.size() + count);
+        read(bytes.data() + bytes.size() - count, count);
     }
 
-    if (!found_digit)
+    if (sign > 1 || (length == 0 && sign == 1) || (length > 0 && bytes.back() == 0))
     {
-        in.setstate(std::ios::failbit);
-        return false;
+        throw std::invalid_argument("malformed record");
     }
 
-    x.value = digits;
-    x.sign = !negative;
-    x.removeLeadingZeros();
+    BigInteger result = from_bytes(bytes, std::endian::little);
+    result.negative = sign == 1;
+    return result;
+}
 
-    if (x.value == "0")
+inline BigInteger BigInteger::sliceLimbs(size_t from, size_t count) const
+{
+    // magnitude of limbs [from, from + count)
+    if (from >= limbs.size())
     {
-        x.sign = true;
+        return BigInteger(0);
     }
 
-    return true;
+    return fromLimbs(limbs.data() + from, std::min(count, limbs.size() - from));
 }
 
-inline std::istream& operator>>(std::istream& lhs, BigInteger& rhs)
+inline void BigInteger::shiftLimbsLeft(size_t count)
 {
-    bool success = readBigInteger(lhs, rhs);
-    if (!success)
+    if (!limbs.empty())
     {
-        if (!lhs.fail())
-        {
-            lhs.setstate(std::ios::failbit);
-        }
+        limbs.insert(limbs.begin(), count, 0);
     }
-    return lhs;
 }
 
-#endif
-
-/* More operators */
-
-inline double BigInteger::sqrt() const
+inline void BigInteger::shiftMagnitudeLeft(size_t bits)
 {
-    if (!sign)
+    if (limbs.empty())
     {
-        throw std::runtime_error("negative number");
+        return;
     }
 
-    double result = 0;
+    size_t bit_shift = bits % 64;
 
-    try {
-        result = std::stod(value);
-        if (std::isinf(result))
+    if (bit_shift != 0)
+    {
+        uint64_t carry = 0;
+        for (uint64_t& limb : limbs)
         {
-            throw std::runtime_error("large number");
+            uint64_t next = limb >> (64 - bit_shift);
+            limb = (limb << bit_shift) | carry;
+            carry = next;
+        }
+        if (carry != 0)
+        {
+            limbs.push_back(carry);
         }
-    } catch (const std::out_of_range&) {
-        throw std::runtime_error("large number");
     }
 
-    return std::sqrt(result);
+    shiftLimbsLeft(bits / 64);
 }
 
-#if SUPPORT_MORE_OPS == 1
-
-inline BigInteger BigInteger::isqrt() const
+inline void BigInteger::shiftMagnitudeRight(size_t bits)
 {
-    if (!sign)
+    size_t limb_shift = bits / 64;
+    size_t bit_shift = bits % 64;
+
+    if (limb_shift >= limbs.size())
     {
-        throw std::runtime_error("negative number");
+        limbs.clear();
+        negative = false;
+        return;
     }
 
-    if (*this == BigInteger(0) || *this == BigInteger(1))
+    limbs.erase(limbs.begin(), limbs.begin() + limb_shift);
+
+    if (bit_shift != 0)
     {
-        return *this;
+        for (size_t i = 0; i + 1 < limbs.size(); i++)
+        {
+            limbs[i] = (limbs[i] >> bit_shift) | (limbs[i + 1] << (64 - bit_shift));
+        }
+        limbs.back() >>= bit_shift;
     }
 
-    BigInteger low(1);
-    BigInteger high = *this;
-    BigInteger result(0);
+    removeLeadingZeros();
+}
 
-    while (low <= high)
+template <typename Multiply, typename Square>
+inline BigInteger BigInteger::slidingWindowPower(const BigInteger& base, const BigInteger& exponent, const BigInteger& one, Multiply multiply, Square square)
+{
+    // left-to-right sliding window over a non-negative exponent: every window ends
+    // in a set bit, so only the odd powers base^1, base^3, ..., base^(2^width - 1) are needed
+    size_t bits = exponent.bit_length();
+    size_t width = bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : bits <= 1792 ? 6 : 7;
+
+    std::vector<BigInteger> odd_powers(size_t(1) << (width - 1));
+    odd_powers[0] = base;
+    if (odd_powers.size() > 1)
     {
-        BigInteger mid = (low + high) / BigInteger(2);
-        BigInteger square = mid * mid;
+        BigInteger base_squared = square(base);
+        for (size_t i = 1; i < odd_powers.size(); i++)
+        {
+            odd_powers[i] = multiply(odd_powers[i - 1], base_squared);
+        }
+    }
+
+    BigInteger result = one;
+    bool started = false;
 
-        if (square == *this)
+    for (size_t i = bits; i-- > 0;)
+    {
+        if (!exponent.test_bit(i))
         {
-            return mid;
+            if (started)
+            {
+                result = square(result);
+            }
+            continue;
         }
-        else if (square < *this)
+
+        size_t low = i + 1 >= width ? i + 1 - width : 0;
+        while (!exponent.test_bit(low))
         {
-            low = mid + BigInteger(1);
-            result = mid;
+            low++;
         }
-        else
+
+        size_t window = 0;
+        for (size_t j = i + 1; j-- > low;)
         {
-            high = mid - BigInteger(1);
+            window = (window << 1) | (exponent.test_bit(j) ? 1 : 0);
+            if (started)
+            {
+                result = square(result);
+            }
         }
+
+        result = started ? multiply(result, odd_powers[window >> 1]) : odd_powers[window >> 1];
+        started = true;
+        i = low;
     }
 
     return result;
 }
 
-inline bool BigInteger::is_prime(size_t k) const {
-    if (*this <= BigInteger(1))
+inline BigInteger BigInteger::randomRange(const BigInteger& low, const BigInteger& high)
+{
+    if (low > high)
     {
-        return false;
+        throw std::invalid_argument("low bound");
     }
 
-    if (*this == BigInteger(2) || *this == BigInteger(3))
+    BigInteger range = high - low + 1;
+    BigInteger randomNumber;
+
+    std::mt19937_64 rng(std::random_device{}());
+
+    // uniform numbers of the bit length of range, rejected until one is below it
+    size_t bits = range.bit_length();
+    size_t top_bits = bits % 64;
+
+    do
     {
-        return true;
+        randomNumber.limbs.resize((bits + 63) / 64);
+        for (uint64_t& limb : randomNumber.limbs)
+        {
+            limb = rng();
+        }
+        if (top_bits != 0)
+        {
+            randomNumber.limbs.back() &= (uint64_t(1) << top_bits) - 1;
+        }
+        randomNumber.removeLeadingZeros();
     }
+    while (randomNumber >= range);
+
+    return low + randomNumber;
+}
+
+inline std::vector<std::vector<BigInteger>> BigInteger::productTree(const std::vector<BigInteger>& leaves)
+{
+    // level 0 holds the leaves, each next level the products of adjacent pairs,
+    // an unpaired last node moves up unchanged; the last level is the full product
+    std::vector<std::vector<BigInteger>> tree = {leaves};
 
-    if (*this % BigInteger(2) == BigInteger(0))
+    while (tree.back().size() > 1)
     {
-        return false;
+        const std::vector<BigInteger>& below = tree.back();
+        std::vector<BigInteger> level((below.size() + 1) / 2);
+
+        for (size_t j = 0; j < level.size(); j++)
+        {
+            level[j] = 2 * j + 1 < below.size() ? below[2 * j] * below[2 * j + 1] : below[2 * j];
+        }
+        tree.push_back(std::move(level));
     }
 
-    BigInteger n_minus_one = *this - BigInteger(1);
-    BigInteger d = n_minus_one;
-    size_t s = 0;
+    return tree;
+}
 
+inline BigInteger::uint128 BigInteger::binaryGcd(uint128 a, uint128 b)
+{
+    // stein: strip common factors of two, then subtract the smaller odd value from the larger
+    auto trailing = [](uint128 value)
+    {
+        uint64_t low = static_cast<uint64_t>(value);
+        return low != 0 ? std::countr_zero(low) : 64 + std::countr_zero(static_cast<uint64_t>(value >> 64));
+    };
 
-    while (d % BigInteger(2) == BigInteger(0))
+    if (a == 0 || b == 0)
     {
-        d /= BigInteger(2);
-        s++;
+        return a | b;
     }
 
-    for (size_t i = 0; i < k; i++)
+    int shift = trailing(a | b);
+    a >>= trailing(a);
+    do
     {
-        BigInteger a = randomRange(BigInteger(2), *this - BigInteger(2));
-        BigInteger x = modulusPower(a, d, *this);
-
-        if (x == BigInteger(1) || x == n_minus_one)
+        b >>= trailing(b);
+        if (a > b)
         {
-            continue;
+            std::swap(a, b);
         }
+        b -= a;
+    }
+    while (b != 0);
 
-        bool is_composite = true;
+    return a << shift;
+}
 
-        for (size_t r = 1; r < s; r++)
+inline std::array<int64_t, 4> BigInteger::lehmerCofactors(const BigInteger& a, const BigInteger& b)
+{
+    // knuth's algorithm L for a >= b >= 0, a of at least two limbs: the euclidean quotients of
+    // the leading 63 bits of a and the bits of b at the same position are taken while both bounds
+    // (x + A) / (y + C) and (x + B) / (y + D) agree, so they equal those of a and b;
+    // returns {A, B, C, D} with (A a + B b, C a + D b) the remainders reached, B = 0 for no step
+    size_t shift = a.bit_length() - 63;
+    int128 x = a.bitsFrom(shift);
+    int128 y = b.bitsFrom(shift);
+    int128 cofactors[4] = {1, 0, 0, 1};
+
+    while (y + cofactors[2] != 0 && y + cofactors[3] != 0)
+    {
+        int128 q = (x + cofactors[0]) / (y + cofactors[2]);
+        if (q != (x + cofactors[1]) / (y + cofactors[3]))
         {
-            x = (x * x) % *this;
-            if (x == n_minus_one)
-            {
-                is_composite = false;
-                break;
-            }
+            break;
         }
 
-        if (is_composite) return false;
+        int128 next[3] = {cofactors[0] - q * cofactors[2], cofactors[1] - q * cofactors[3], x - q * y};
+        cofactors[0] = cofactors[2];
+        cofactors[1] = cofactors[3];
+        cofactors[2] = next[0];
+        cofactors[3] = next[1];
+        x = y;
+        y = next[2];
     }
 
-    return true;
+    return {static_cast<int64_t>(cofactors[0]), static_cast<int64_t>(cofactors[1]),
+            static_cast<int64_t>(cofactors[2]), static_cast<int64_t>(cofactors[3])};
 }
 
-#endif
-
-#if SUPPORT_EVAL == 1
-
-inline std::string removeSpaces(const std::string& string)  // string = "{ \"op\" : \"+\", \"left\" : 123, \"right\" : 456 }"
+inline void BigInteger::lehmerUpdate(BigInteger& a, BigInteger& b, const std::array<int64_t, 4>& cofactors)
 {
-    std::string result;
-
-    for (char ch : string)
+    // (a, b) = (A a + B b, C a + D b) in place and in one pass; A, B and C, D have opposite signs,
+    // so a limb product sum with its carry fits a signed 128-bit value and both results are non-negative
+    size_t size = a.limbs.size();
+    b.limbs.resize(size);
+
+    int128 carry_a = 0;
+    int128 carry_b = 0;
+    for (size_t i = 0; i < size; i++)
     {
-        if (!std::isspace(ch))
-        {
-            result += ch;
-        }
+        int128 x = static_cast<int128>(a.limbs[i]);
+        int128 y = static_cast<int128>(b.limbs[i]);
+        int128 sum_a = cofactors[0] * x + cofactors[1] * y + carry_a;
+        int128 sum_b = cofactors[2] * x + cofactors[3] * y + carry_b;
+        a.limbs[i] = static_cast<uint64_t>(sum_a);
+        b.limbs[i] = static_cast<uint64_t>(sum_b);
+        carry_a = sum_a >> 64;
+        carry_b = sum_b >> 64;
     }
-    return result;  // result = "{\"op\":\"+\",\"left\":123,\"right\":456}"
-}
 
+    a.removeLeadingZeros();
+    b.removeLeadingZeros();
+}
 
-inline std::string findValue(const std::string& json, const std::string& key, size_t& pos)
+inline void BigInteger::lehmerUpdateCoefficients(BigInteger& u, BigInteger& v, const std::array<int64_t, 4>& cofactors)
 {
-    size_t key_pos = json.find("\"" + key + "\":", pos);
+    // (u, v) = (A u + B v, C u + D v) for the signed bezout coefficients that follow a lehmer step
+    BigInteger x = u * cofactors[0] + v * cofactors[1];
+    BigInteger y = u * cofactors[2] + v * cofactors[3];
+    u = std::move(x);
+    v = std::move(y);
+}
 
-    if (key_pos == std::string::npos)
+inline BigInteger::GcdMatrix BigInteger::halfGcd(BigInteger& a, BigInteger& b, bool with_matrix)
+{
+    // reduces a >= b >= 0 of n limbs along their remainder sequence until b has about n / 2 limbs
+    // and returns the unimodular matrix M with (a', b') = M (a, b); the quotients of the leading
+    // half determine M for the whole, so below the threshold lehmer steps are collected and above it
+    // the leading limbs are reduced recursively, twice, with one full division in between;
+    // gcd only needs the reduced operands, and without with_matrix the returned M is not meaningful
+    GcdMatrix matrix = {BigInteger(1), BigInteger(0), BigInteger(0), BigInteger(1)};
+    size_t n = a.limbs.size();
+    size_t s = n / 2 + 1;
+
+    if (b.limbs.size() <= s)
     {
-        throw std::invalid_argument(key);
+        return matrix;
     }
-
-    size_t value_pos = key_pos + key.length() + 3;
-
-    if (json[value_pos] == '{')
+    if (n < half_gcd_threshold / 4)
     {
-        // object
-        size_t brace_count = 1;
-        size_t end_pos = value_pos + 1;
-        while (brace_count > 0 && end_pos < json.length())
+        // a product of euclidean steps has the sign pattern +- / -+ or its negation, so only the
+        // magnitudes are accumulated, and a step adds products instead of cancelling them
+        GcdMatrix magnitude = matrix;
+        bool flipped = false;
+        auto combine = [](const BigInteger& x, uint64_t p, const BigInteger& y, uint64_t q)
         {
-            if (json[end_pos] == '{')
+            BigInteger result = x;
+            BigInteger addend = y;
+            result.multiplySmall(p, false);
+            addend.multiplySmall(q, false);
+            result.addMagnitude(addend, false);
+            return result;
+        };
+
+        while (b.limbs.size() > s)
+        {
+            std::array<int64_t, 4> cofactors = lehmerCofactors(a, b);
+            if (cofactors[1] == 0)
             {
-                brace_count += 1;
+                auto [q, r] = a.divmod(b);
+                a = std::move(b);
+                b = std::move(r);
+                magnitude = {magnitude[2], magnitude[3], magnitude[0] + q * magnitude[2], magnitude[1] + q * magnitude[3]};
+                flipped = !flipped;
             }
-            else if (json[end_pos] == '}')
+            else
             {
-                brace_count-=1;
+                lehmerUpdate(a, b, cofactors);
+                std::array<uint64_t, 4> c;
+                for (size_t i = 0; i < 4; i++)
+                {
+                    c[i] = cofactors[i] < 0 ? -static_cast<uint64_t>(cofactors[i]) : static_cast<uint64_t>(cofactors[i]);
+                }
+                magnitude = {combine(magnitude[0], c[0], magnitude[2], c[1]), combine(magnitude[1], c[0], magnitude[3], c[1]),
+                             combine(magnitude[0], c[2], magnitude[2], c[3]), combine(magnitude[1], c[2], magnitude[3], c[3])};
+                flipped = (flipped != (cofactors[0] + cofactors[3] < 0));
             }
-            end_pos+=1;
         }
-        if (brace_count != 0)
+
+        // entries 1 and 2 are the negative ones, or 0 and 3 when flipped
+        size_t first = flipped ? 0 : 1;
+        matrix = std::move(magnitude);
+        matrix[first] = -std::move(matrix[first]);
+        matrix[3 - first] = -std::move(matrix[3 - first]);
+        return matrix;
+    }
+
+    // M (a, b) = M (a_high, b_high) B^p + M (a_low, b_low), and the recursion already returns the
+    // first term reduced, so M only multiplies the p low limbs; a split two limbs above the middle
+    // leaves the entries of M a little under n / 4 limbs, so that their products with the entries of
+    // the second matrix stay within n / 2 limbs, a power of two for the NTT when n is one
+    size_t p = n / 2 + 2;
+    BigInteger a_high = a.sliceLimbs(p, n);
+    BigInteger b_high = b.sliceLimbs(p, n);
+    matrix = halfGcd(a_high, b_high);
+    applyGcdMatrix(matrix, a, b, std::move(a_high), std::move(b_high), p);
+
+    if (b.limbs.size() > s)
+    {
+        auto [q, r] = a.divmod(b);
+        a = std::move(b);
+        b = std::move(r);
+        if (with_matrix)
         {
-            throw std::invalid_argument("end brace");
+            matrix = {matrix[2], matrix[3], matrix[0] - q * matrix[2], matrix[1] - q * matrix[3]};
         }
-
-        pos = end_pos;
-        return json.substr(value_pos, end_pos - value_pos);
     }
-    else if (json[value_pos] == '"')
+    if (b.limbs.size() > s)
     {
-        // string
-        size_t end_pos = json.find('"', value_pos + 1);
-
-        if (end_pos == std::string::npos)
+        // the leading 2 (m - s) limbs reduce by about the m - s limbs still above s; without a margin
+        // b may end a few limbs above s, which costs callers less than larger entries here
+        size_t m = a.limbs.size();
+        size_t from = 2 * s > m ? 2 * s - m : 0;
+        a_high = a.sliceLimbs(from, m);
+        b_high = b.sliceLimbs(from, m);
+        GcdMatrix second = halfGcd(a_high, b_high);
+        applyGcdMatrix(second, a, b, std::move(a_high), std::move(b_high), from);
+        if (with_matrix)
         {
-            throw std::invalid_argument("end quotation mark");
+            matrix = multiplyGcdMatrices(second, matrix);
         }
+    }
 
-        pos = end_pos + 1;
-        return json.substr(value_pos + 1, end_pos - value_pos - 1);
+    return matrix;
+}
+
+inline BigInteger::GcdMatrix BigInteger::multiplyGcdMatrices(const GcdMatrix& lhs, const GcdMatrix& rhs)
+{
+    return {lhs[0] * rhs[0] + lhs[1] * rhs[2], lhs[0] * rhs[1] + lhs[1] * rhs[3],
+            lhs[2] * rhs[0] + lhs[3] * rhs[2], lhs[2] * rhs[1] + lhs[3] * rhs[3]};
+}
+
+inline void BigInteger::applyGcdMatrix(GcdMatrix& matrix, BigInteger& a, BigInteger& b, BigInteger&& a_high, BigInteger&& b_high, size_t split)
+{
+    // (a, b) = M (a, b) from the reduced (a_high, b_high) = M (a >> split limbs, b >> split limbs) and
+    // the low limbs; M was found on leading limbs only, so its last quotients may be off for the
+    // whole, and negating or swapping rows of M keeps it unimodular and restores a >= b >= 0
+    BigInteger a_low = a.sliceLimbs(0, split);
+    BigInteger b_low = b.sliceLimbs(0, split);
+    BigInteger x = matrix[0] * a_low + matrix[1] * b_low;
+    BigInteger y = matrix[2] * a_low + matrix[3] * b_low;
+    a_high.shiftLimbsLeft(split);
+    b_high.shiftLimbsLeft(split);
+    x += a_high;
+    y += b_high;
+
+    if (x.negative)
+    {
+        x.negative = false;
+        matrix[0] = -std::move(matrix[0]);
+        matrix[1] = -std::move(matrix[1]);
     }
-    else
+    if (y.negative)
     {
-        // number
-        size_t end_pos = value_pos;
-        while (end_pos < json.length() && (std::isdigit(json[end_pos]) || json[end_pos] == '-' || json[end_pos] == '.'))
+        y.negative = false;
+        matrix[2] = -std::move(matrix[2]);
+        matrix[3] = -std::move(matrix[3]);
+    }
+    if (compareLimbs(x.limbs.data(), x.limbs.size(), y.limbs.data(), y.limbs.size()) < 0)
+    {
+        std::swap(x, y);
+        std::swap(matrix[0], matrix[2]);
+        std::swap(matrix[1], matrix[3]);
+    }
+
+    a = std::move(x);
+    b = std::move(y);
+}
+
+#if SUPPORT_MORE_OPS == 1
+
+inline BigInteger BigInteger::sqrtRemainder(const BigInteger& n, BigInteger& remainder)
+{
+    // n >= 0, floor(sqrt(n)) with remainder n - root^2
+    size_t bits = n.bit_length();
+    if (bits <= 104)
+    {
+        // a double root of up to 104 bits is off by a unit at most
+        uint128 value = n.toNative();
+        uint128 root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+        while (root * root > value)
         {
-            end_pos +=1 ;
+            --root;
+        }
+        while ((root + 1) * (root + 1) <= value)
+        {
+            ++root;
         }
+        remainder.assignNative(value - root * root, false);
 
-        pos = end_pos;
-        return json.substr(value_pos, end_pos - value_pos);
+        BigInteger result;
+        result.assignNative(root, false);
+        return result;
+    }
+
+    // the root of the leading half of the bits is off by less than 2^(shift / 2), one newton step from
+    // below squares that error away and lands on the root or one above it
+    size_t shift = (bits - 4) / 4 * 2;
+    BigInteger root = sqrtRemainder(n >> shift, remainder) << (shift / 2);
+    root = (root + n / root) >> 1;
+
+    remainder = n - root.square();
+    if (remainder.negative)
+    {
+        remainder += root;
+        root -= 1;
+        remainder += root;
     }
+    return root;
 }
 
-inline BigInteger evaluate(const std::string& json)
+inline BigInteger BigInteger::rootNewton(const BigInteger& n, uint64_t k)
 {
-    std::string json_format = removeSpaces(json);
+    // n > 0 and k >= 2, floor(n^(1/k))
+    size_t bits = n.bit_length();
+    if (bits <= k)
+    {
+        return BigInteger(1);
+    }
 
-    if (json_format.empty())
+    size_t root_bits = (bits - 1) / k + 1;
+    BigInteger root;
+    if (root_bits <= 52)
     {
-        throw std::invalid_argument("empty json");
+        size_t shift = bits > 64 ? bits - 64 : 0;
+        double log = std::log2(static_cast<double>(n.bitsFrom(shift))) + static_cast<double>(shift);
+        root = BigInteger(static_cast<uint64_t>(std::exp2(log / static_cast<double>(k))) + 1);
+    }
+    else
+    {
+        // the root of the leading bits, rounded up and scaled back, is above the root
+        // and correct in about half of its bits
+        size_t shift = root_bits / 2;
+        root = (rootNewton(n >> (shift * k), k) + 1) << shift;
     }
 
-    if (json_format[0] != '{')
+    // by the mean inequality a newton step from any start is at least the root, and from above
+    // the steps descend strictly until they reach it
+    auto step = [&](const BigInteger& x)
     {
-        // string or number
-        if (json_format[0] == '"')
-        {
-            // string
-            if (json_format.back() != '"')
-            {
-                throw std::invalid_argument("end string");
-            }
+        BigInteger next = n / pow(x, k - 1) + x * (k - 1);
+        next.divideSmall(k, false);
+        return next;
+    };
 
-            std::string value = json_format.substr(1, json_format.length() - 2);
-            return BigInteger(value);
-        }
-        else
-        {
-            // number
-            size_t dot_pos = json_format.find('.'); // remove decimal part
+    root = step(root);
+    for (BigInteger next = step(root); next < root; next = step(root))
+    {
+        root = std::move(next);
+    }
+    return root;
+}
 
-            std::string integer_part = (dot_pos == std::string::npos) ? json_format : json_format.substr(0, dot_pos);
-            return BigInteger(integer_part);
-        }
+#endif
+
+/*
+ * MontgomeryContext definitions
+ */
+
+/* Constructors */
+
+inline MontgomeryContext::MontgomeryContext(const BigInteger& modulus) : n(modulus), size(modulus.limbs.size())
+{
+    if (modulus.sign() <= 0 || modulus.is_even())
+    {
+        throw std::invalid_argument("montgomery modulus");
     }
-    // object with "op", "left", "rigth" in {}
 
-    size_t pos = 1;
+    n_prime = 0 - BigInteger::inverseLimb(n.limbs[0]);
 
-    // op
-    std::string op = findValue(json_format, "op", pos);
+    r_mod = (BigInteger(1) << (64 * size)) % n;
+    r_squared = (BigInteger(1) << (128 * size)) % n;
+}
 
-    // left
-    std::string left_str = findValue(json_format, "left", pos);
-    BigInteger left_value = evaluate(left_str);
+/* Conversion */
 
-    // right
-    std::string right_str = findValue(json_format, "right", pos);
-    BigInteger right_value = evaluate(right_str);
+inline BigInteger MontgomeryContext::to_montgomery(const BigInteger& x) const
+{
+    BigInteger residue = x % n;
+    if (residue.sign() < 0)
+    {
+        residue += n;
+    }
+    return multiply(residue, r_squared);
+}
 
-    if (op == "+")
+inline BigInteger MontgomeryContext::from_montgomery(const BigInteger& x) const
+{
+    if (x.negative || x.limbs.size() > size)
     {
-        return left_value + right_value;
+        throw std::invalid_argument("montgomery residue");
     }
-    else if (op == "-")
+
+    BigInteger::Limbs t(2 * size + 1, 0);
+    std::copy(x.limbs.begin(), x.limbs.end(), t.begin());
+    return reduce(t);
+}
+
+/* Arithmetics */
+
+inline BigInteger MontgomeryContext::multiply(const BigInteger& a, const BigInteger& b) const
+{
+    if (a.negative || b.negative || a.limbs.size() > size || b.limbs.size() > size)
     {
-        return left_value - right_value;
+        throw std::invalid_argument("montgomery residue");
     }
-    else if (op == "*")
+
+    BigInteger::Limbs t(2 * size + 1, 0);
+
+    size_t a_size = a.limbs.size();
+    size_t b_size = b.limbs.size();
+
+    if (a_size != 0 && b_size != 0)
     {
-        return left_value * right_value;
+        if (a_size >= b_size)
+        {
+            BigInteger::multiplyLimbs(t.data(), a.limbs.data(), a_size, b.limbs.data(), b_size);
+        }
+        else
+        {
+            BigInteger::multiplyLimbs(t.data(), b.limbs.data(), b_size, a.limbs.data(), a_size);
+        }
     }
-    else if (op == "/")
+
+    return reduce(t);
+}
+
+inline BigInteger MontgomeryContext::square(const BigInteger& a) const
+{
+    if (a.negative || a.limbs.size() > size)
     {
-        return left_value / right_value;
+        throw std::invalid_argument("montgomery residue");
     }
-    else if (op == "%")
+
+    BigInteger::Limbs t(2 * size + 1, 0);
+
+    if (!a.limbs.empty())
     {
-        return left_value % right_value;
+        BigInteger::squareLimbs(t.data(), a.limbs.data(), a.limbs.size());
     }
-    else
+
+    return reduce(t);
+}
+
+inline BigInteger MontgomeryContext::power(const BigInteger& base, const BigInteger& exponent) const
+{
+    if (exponent.sign() < 0)
     {
-        throw std::invalid_argument("unknown operator");
+        throw std::invalid_argument("negative exponent");
     }
+
+    return BigInteger::slidingWindowPower(base, exponent, r_mod,
+        [this](const BigInteger& x, const BigInteger& y) { return multiply(x, y); },
+        [this](const BigInteger& x) { return square(x); });
 }
 
+/* Access */
 
-inline BigInteger eval(const std::string& input)
+inline const BigInteger& MontgomeryContext::modulus() const
 {
-    return evaluate(input);
+    return n;
 }
 
-#endif
+inline const BigInteger& MontgomeryContext::one() const
+{
+    return r_mod;
+}
 
 /* Assistants */
 
-inline void BigInteger::removeLeadingZeros()
+inline BigInteger MontgomeryContext::reduce(BigInteger::Limbs& t) const
 {
-    size_t pos = value.find_first_not_of('0');
+    // word-by-word REDC of t < n * R held in 2 * size + 1 limbs: t * R^-1 mod n,
+    // the carry out of each row is deferred into the next row instead of rippling
+    uint64_t deferred = 0;
 
-    if (pos == std::string::npos)
+    for (size_t i = 0; i < size; i++)
     {
-        value = "0";
-        sign = true;
+        uint64_t m = t[i] * n_prime;
+        uint64_t carry = BigInteger::addMultiplyLimb(t.data() + i, n.limbs.data(), size, m);
+
+        BigInteger::uint128 sum = static_cast<BigInteger::uint128>(t[i + size]) + carry + deferred;
+        t[i + size] = static_cast<uint64_t>(sum);
+        deferred = static_cast<uint64_t>(sum >> 64);
     }
-    else
+    t[2 * size] = deferred;
+
+    BigInteger result;
+    result.limbs.assign(t.begin() + size, t.end());
+    result.removeLeadingZeros();
+
+    if (BigInteger::compareLimbs(result.limbs.data(), result.limbs.size(), n.limbs.data(), size) >= 0)
     {
-        value.erase(0, pos);
+        BigInteger::subtractLimbs(result.limbs.data(), result.limbs.data(), result.limbs.size(), n.limbs.data(), size);
+        result.removeLeadingZeros();
     }
-}
 
-inline std::string BigInteger::addStrings(const std::string& a, const std::string& b)
-{
-    std::string result;
+    return result;
+}
 
-    int carry = 0;
-    int sum = 0;
+/*
+ * BarrettReducer definitions
+ */
 
-    int a_len = a.size();
-    int b_len = b.size();
+/* Constructors */
 
-    for (int i = 0; i < std::max(a_len, b_len) || carry; i++)
+inline BarrettReducer::BarrettReducer(const BigInteger& modulus) : m(modulus), size(modulus.limbs.size())
+{
+    if (modulus.sign() <= 0)
     {
-        int digit_a = i < a_len ? a[a_len - i - 1] - '0' : 0;
-        int digit_b = i < b_len ? b[b_len - i - 1] - '0' : 0;
-        sum = digit_a + digit_b + carry;
-        result += (sum % 10) + '0';
-        carry = sum / 10;
+        throw std::invalid_argument("barrett modulus");
     }
 
-    std::reverse(result.begin(), result.end());
-    return result;
+    mu = (BigInteger(1) << (128 * size)) / m;
 }
 
-inline std::string BigInteger::subtractStrings(const std::string& a, const std::string& b)
+/* Reduction */
+
+inline BigInteger BarrettReducer::reduce(const BigInteger& x) const
 {
-    std::string result;
+    BigInteger r;
 
-    int borrow = 0;
-    int difference = 0;
+    if (x.limbs.size() > 2 * size)
+    {
+        // beyond the precomputed range
+        r = x % m;
+    }
+    else if (size < BigInteger::toom3_threshold)
+    {
+        // below the Toom-Cook sizes only half of each product is formed with schoolbook rows: the top
+        // of |x| / B^(k-1) * mu from column k - 1 on, and the bottom k + 1 limbs of q * m, as r < B^(k+1)
+        size_t n = x.limbs.size();
+        size_t k = size;
+        BigInteger::Limbs q;
 
-    int a_len = a.size();
-    int b_len = b.size();
+        if (n >= k)
+        {
+            size_t q1_size = n - (k - 1);
+            size_t mu_size = mu.limbs.size();
+            BigInteger::Limbs high(q1_size + mu_size - (k - 1));
+            BigInteger::multiplyHigh(high.data(), x.limbs.data() + (k - 1), q1_size, mu.limbs.data(), mu_size, k - 1);
+            q.assign(high.begin() + std::min<size_t>(2, high.size()), high.end());
+        }
 
-    for (int i = 0; i < a_len; i++)
-    {
-        int digit_a = a[a_len - i - 1] - '0';
-        int digit_b = i < b_len ? b[b_len - i - 1] - '0' : 0;
-        difference = digit_a - digit_b - borrow;
+        BigInteger::Limbs low(k + 1, 0);
+        std::copy(x.limbs.begin(), x.limbs.begin() + std::min(n, k + 1), low.begin());
 
-        if (difference < 0)
+        if (!q.empty())
         {
-            difference += 10;
-            borrow = 1;
+            BigInteger::Limbs product(k + 1);
+            BigInteger::multiplyLow(product.data(), q.data(), q.size(), m.limbs.data(), k, k + 1);
+            BigInteger::subtractLimbs(low.data(), low.data(), k + 1, product.data(), k + 1);
         }
-        else
+
+        r.limbs = std::move(low);
+        r.removeLeadingZeros();
+        while (BigInteger::compareLimbs(r.limbs.data(), r.limbs.size(), m.limbs.data(), k) >= 0)
         {
-            borrow = 0;
+            BigInteger::subtractLimbs(r.limbs.data(), r.limbs.data(), r.limbs.size(), m.limbs.data(), k);
+            r.removeLeadingZeros();
         }
 
-        result += difference + '0';
+        r.negative = x.negative && !r.limbs.empty();
     }
+    else
+    {
+        // Menezes et al., Handbook of Applied Cryptography, algorithm 14.42:
+        // q = floor(floor(|x| / B^(k-1)) * mu / B^(k+1)) is at most 2 below the true quotient
+        BigInteger q = x.sliceLimbs(size - 1, x.limbs.size()) * mu;
+        q.shiftMagnitudeRight(64 * (size + 1));
 
-    std::reverse(result.begin(), result.end());
-    return result;
-}
+        r = x.sliceLimbs(0, x.limbs.size()) - q * m;
+        while (r >= m)
+        {
+            r -= m;
+        }
 
-inline void BigInteger::divisionAndModulus(const BigInteger& rhs, BigInteger& quotient, BigInteger& remainder) const
-{
-    if (rhs.value == "0")
-    {
-        throw std::logic_error("zero division");
+        r.negative = x.negative && !r.limbs.empty();
     }
 
-    if (value == "0")
+    if (r.negative)
     {
-        quotient = BigInteger(0);
-        remainder = BigInteger(0);
-        return;
+        r += m;
     }
 
-    BigInteger dividend = *this;
-    dividend.sign = true;
+    return r;
+}
+
+/* Arithmetics */
+
+inline BigInteger BarrettReducer::multiply(const BigInteger& a, const BigInteger& b) const
+{
+    return reduce(a * b);
+}
 
-    BigInteger divisor = rhs;
-    divisor.sign = true;
+inline BigInteger BarrettReducer::square(const BigInteger& a) const
+{
+    return reduce(a.square());
+}
 
-    if (dividend < divisor)
+inline BigInteger BarrettReducer::power(const BigInteger& base, const BigInteger& exponent) const
+{
+    if (exponent.sign() < 0)
     {
-        quotient = BigInteger(0);
-        remainder = dividend;
-        return;
+        throw std::invalid_argument("negative exponent");
     }
 
-    std::string result;
-    BigInteger current;
+    return BigInteger::slidingWindowPower(reduce(base), exponent, reduce(BigInteger(1)),
+        [this](const BigInteger& x, const BigInteger& y) { return multiply(x, y); },
+        [this](const BigInteger& x) { return square(x); });
+}
 
-    for (char i : dividend.value)
-    {
-        current.value += i;
-        current.removeLeadingZeros();
+/* Access */
 
-        int count = 0;
-        while (current >= divisor)
-        {
-            current -= divisor;
-            ++count;
-        }
-        result += (count + '0');
-    }
+inline const BigInteger& BarrettReducer::modulus() const
+{
+    return m;
+}
 
-    quotient.value = result;
-    quotient.sign = (sign == rhs.sign);
-    quotient.removeLeadingZeros();
+/*
+ * ModularContext
+ */
+
+// A modulus shared by ModInt values: Montgomery arithmetic for odd moduli, Barrett reduction
+// otherwise. Values live in the internal form of the chosen reduction between operations.
+
+class ModularContext
+{
+public:
+    // constructors
+    explicit ModularContext(const BigInteger& modulus);
+
+    // access
+    const BigInteger& modulus() const;
+
+private:
+    // realization
+    std::variant<MontgomeryContext, BarrettReducer> reduction;
+
+    // friends
+    friend class ModInt;
+
+    // assistants
+    BigInteger toInternal(const BigInteger& x) const;
+    BigInteger fromInternal(const BigInteger& x) const;
+    BigInteger multiply(const BigInteger& a, const BigInteger& b) const;
+    BigInteger power(const BigInteger& base, const BigInteger& exponent) const;
+};
+
+/* Constructors */
+
+inline ModularContext::ModularContext(const BigInteger& modulus)
+    : reduction(modulus.sign() > 0 && !modulus.is_even()
+        ? std::variant<MontgomeryContext, BarrettReducer>(std::in_place_type<MontgomeryContext>, modulus)
+        : std::variant<MontgomeryContext, BarrettReducer>(std::in_place_type<BarrettReducer>, modulus))
+{
+}
 
-    remainder = current;
-    remainder.sign = sign;
-    remainder.removeLeadingZeros();
+/* Access */
+
+inline const BigInteger& ModularContext::modulus() const
+{
+    return std::visit([](const auto& context) -> const BigInteger& { return context.modulus(); }, reduction);
 }
 
-inline BigInteger BigInteger::modulusPower(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus)
+/* Assistants */
+
+inline BigInteger ModularContext::toInternal(const BigInteger& x) const
 {
-    if (modulus == BigInteger(0))
+    if (const MontgomeryContext* montgomery = std::get_if<MontgomeryContext>(&reduction))
     {
-        throw std::invalid_argument("zero modulus");
+        return montgomery->to_montgomery(x);
     }
+    return std::get<BarrettReducer>(reduction).reduce(x);
+}
 
-    BigInteger result(1);
-    BigInteger b = base % modulus;
-    BigInteger e = exponent;
+inline BigInteger ModularContext::fromInternal(const BigInteger& x) const
+{
+    if (const MontgomeryContext* montgomery = std::get_if<MontgomeryContext>(&reduction))
+    {
+        return montgomery->from_montgomery(x);
+    }
+    return x;
+}
+
+inline BigInteger ModularContext::multiply(const BigInteger& a, const BigInteger& b) const
+{
+    return std::visit([&](const auto& context) { return &a == &b ? context.square(a) : context.multiply(a, b); }, reduction);
+}
+
+inline BigInteger ModularContext::power(const BigInteger& base, const BigInteger& exponent) const
+{
+    return std::visit([&](const auto& context) { return context.power(base, exponent); }, reduction);
+}
+
+/*
+ * ModInt
+ */
+
+// An integer modulo the modulus of a ModularContext, which must outlive it. Operands of one
+// operation must share a modulus; the value is converted back to BigInteger only by value().
+
+class ModInt
+{
+public:
+    // constructors
+    ModInt(const BigInteger& value, const ModularContext& context);
+
+    // unary operators
+    const ModInt& operator+() const;
+    ModInt operator-() const;
+
+    // binary arithmetics operators
+    ModInt& operator+=(const ModInt& rhs);
+    ModInt& operator-=(const ModInt& rhs);
+    ModInt& operator*=(const ModInt& rhs);
+    ModInt& operator/=(const ModInt& rhs);
+
+    // more operators
+    ModInt pow(const BigInteger& exponent) const;   // a negative exponent inverts first
+    ModInt inverse() const;
+
+    // access
+    BigInteger value() const;       // in [0, modulus)
+    const ModularContext& context() const;
+
+private:
+    // realization
+    BigInteger residue;             // internal form of the context
+    const ModularContext* modular;
+
+    // friends
+    friend bool operator==(const ModInt& lhs, const ModInt& rhs);
+    friend bool operator!=(const ModInt& lhs, const ModInt& rhs);
+
+    // assistants
+    ModInt(BigInteger internal, const ModularContext* context);
+    void checkContext(const ModInt& rhs) const;
+};
+
+/* Constructors */
+
+inline ModInt::ModInt(const BigInteger& value, const ModularContext& context)
+    : residue(context.toInternal(value)), modular(&context)
+{
+}
+
+inline ModInt::ModInt(BigInteger internal, const ModularContext* context)
+    : residue(std::move(internal)), modular(context)
+{
+}
 
-    while (e > BigInteger(0))
+/* Unary operators */
+
+inline const ModInt& ModInt::operator+() const
+{
+    return *this;
+}
+
+inline ModInt ModInt::operator-() const
+{
+    // both internal forms are linear, so negation is m - x
+    return residue.is_zero() ? *this : ModInt(modular->modulus() - residue, modular);
+}
+
+/* Binary arithmetics operators */
+
+inline ModInt& ModInt::operator+=(const ModInt& rhs)
+{
+    checkContext(rhs);
+
+    residue += rhs.residue;
+    if (residue >= modular->modulus())
     {
-        if (e % BigInteger(2) == BigInteger(1))
-        {
-            result = (result * b) % modulus;
-        }
-        e /= BigInteger(2);
-        b = (b * b) % modulus;
+        residue -= modular->modulus();
     }
+    return *this;
+}
 
+inline ModInt operator+(const ModInt& lhs, const ModInt& rhs)
+{
+    ModInt result = lhs;
+    result += rhs;
     return result;
 }
 
-inline BigInteger BigInteger::randomRange(const BigInteger& low, const BigInteger& high)
+inline ModInt& ModInt::operator-=(const ModInt& rhs)
 {
-    if (low > high)
+    checkContext(rhs);
+
+    residue -= rhs.residue;
+    if (residue.sign() < 0)
     {
-        throw std::invalid_argument("low bound");
+        residue += modular->modulus();
     }
+    return *this;
+}
 
-    BigInteger range = high - low + BigInteger(1);
-    BigInteger randomNumber;
+inline ModInt operator-(const ModInt& lhs, const ModInt& rhs)
+{
+    ModInt result = lhs;
+    result -= rhs;
+    return result;
+}
 
-    std::mt19937_64 rng(std::random_device{}());
-    std::uniform_int_distribution<int> bit_dist(0, 1);
+inline ModInt& ModInt::operator*=(const ModInt& rhs)
+{
+    checkContext(rhs);
 
-    do
+    residue = modular->multiply(residue, rhs.residue);
+    return *this;
+}
+
+inline ModInt operator*(const ModInt& lhs, const ModInt& rhs)
+{
+    ModInt result = lhs;
+    result *= rhs;
+    return result;
+}
+
+inline ModInt& ModInt::operator/=(const ModInt& rhs)
+{
+    checkContext(rhs);
+
+    *this *= rhs.inverse();
+    return *this;
+}
+
+inline ModInt operator/(const ModInt& lhs, const ModInt& rhs)
+{
+    ModInt result = lhs;
+    result /= rhs;
+    return result;
+}
+
+/* More operators */
+
+inline ModInt ModInt::pow(const BigInteger& exponent) const
+{
+    if (exponent.sign() < 0)
     {
-        randomNumber = BigInteger(0);
-        for (size_t i = 0; i < bitLength(range); i++)
-        {
-            randomNumber = randomNumber * BigInteger(2) + BigInteger(bit_dist(rng));
-        }
+        return inverse().pow(-exponent);
     }
-    while (randomNumber >= range);
 
-    return low + randomNumber;
+    return ModInt(modular->power(residue, exponent), modular);
+}
+
+inline ModInt ModInt::inverse() const
+{
+    return ModInt(BigInteger::mod_inverse(value(), modular->modulus()), *modular);
+}
+
+/* Access */
+
+inline BigInteger ModInt::value() const
+{
+    return modular->fromInternal(residue);
+}
+
+inline const ModularContext& ModInt::context() const
+{
+    return *modular;
 }
 
-inline size_t BigInteger::bitLength(const BigInteger& number)
+/* Logical operators */
+
+inline bool operator==(const ModInt& lhs, const ModInt& rhs)
+{
+    lhs.checkContext(rhs);
+    return lhs.residue == rhs.residue;
+}
+
+inline bool operator!=(const ModInt& lhs, const ModInt& rhs)
+{
+    return !(lhs == rhs);
+}
+
+/* Friends */
+
+inline std::ostream& operator<<(std::ostream& lhs, const ModInt& rhs)
 {
-    BigInteger temp = number;
-    size_t bits = 0;
+    return lhs << rhs.value();
+}
 
-    while (temp > BigInteger(0))
+/* Assistants */
+
+inline void ModInt::checkContext(const ModInt& rhs) const
+{
+    if (modular != rhs.modular && modular->modulus() != rhs.modular->modulus())
     {
-        temp /= BigInteger(2);
-        bits++;
+        throw std::invalid_argument("different moduli");
     }
-    return bits;
 }
 
 /*
  * BigRational
  */
 
+class BigRationalAccumulator;
+
 class BigRational
 {
 public:
@@ -931,9 +4887,14 @@ public:
     BigRational(const BigRational& other);
     BigRational& operator=(const BigRational& rhs);
 
+    // move
+    BigRational(BigRational&& other) noexcept;
+    BigRational& operator=(BigRational&& rhs) noexcept;
+
     // unary operators
     const BigRational& operator+() const;
-    BigRational operator-() const;
+    BigRational operator-() const&;
+    BigRational operator-() &&;
 
     // binary arithmetics operators
     BigRational& operator+=(const BigRational& rhs);
@@ -946,6 +4907,17 @@ public:
     BigInteger isqrt() const;
 #endif
 
+    // conversion of the exact quotient, rounded to nearest; to_double throws beyond the range of double
+    double to_double() const;
+    std::pair<double, int64_t> frexp() const;     // {m, e}, m * 2^e with 0.5 <= |m| < 1, zero as {0, 0}
+
+    // versioned binary records: the format version byte of BigInteger records followed by the bodies of
+    // the numerator and the denominator, and brought to lowest terms when read
+    std::vector<uint8_t> serialize() const;
+    void serialize(std::ostream& out) const;
+    static BigRational deserialize(std::span<const uint8_t> record, size_t* consumed = nullptr);
+    static BigRational deserialize(std::istream& in);
+
 private:
     // realization
     BigInteger numerator;
@@ -957,6 +4929,11 @@ private:
     friend std::istream& operator>>(std::istream& lhs, BigRational& rhs);
 #endif
 
+    friend BigRational operator+(const BigRational& lhs, const BigRational& rhs);
+    friend BigRational operator-(const BigRational& lhs, const BigRational& rhs);
+    friend BigRational operator*(const BigRational& lhs, const BigRational& rhs);
+    friend BigRational operator/(const BigRational& lhs, const BigRational& rhs);
+
     friend std::strong_ordering operator<=>(const BigRational& lhs, const BigRational& rhs);
     friend bool operator==(const BigRational& lhs, const BigRational& rhs);
     friend bool operator!=(const BigRational& lhs, const BigRational& rhs);
@@ -965,9 +4942,15 @@ private:
     friend bool operator<=(const BigRational& lhs, const BigRational& rhs);
     friend bool operator>=(const BigRational& lhs, const BigRational& rhs);
 
+    friend class BigRationalAccumulator;
+    friend std::strong_ordering operator<=>(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+
     // assistants
     void reduce();
-    static BigInteger gcd(const BigInteger& x, const BigInteger& y);
+    static void add(BigRational& result, const BigRational& lhs, const BigRational& rhs, bool subtract);
+    static void multiply(BigRational& result, const BigRational& lhs, const BigRational& rhs, bool divide);
+    static std::strong_ordering compare(const BigInteger& a, const BigInteger& b, const BigInteger& c, const BigInteger& d);
+    template <typename Read> static BigRational readRecord(Read read);
 
 };
 
@@ -986,7 +4969,7 @@ inline BigRational::BigRational(int64_t a, int64_t b): numerator(a), denominator
 
 inline BigRational::BigRational(const std::string& a, const std::string& b): numerator(a), denominator(b)
 {
-    if (denominator == BigInteger(0))
+    if (denominator.is_zero())
     {
         throw std::invalid_argument("zero division");
     }
@@ -995,7 +4978,7 @@ inline BigRational::BigRational(const std::string& a, const std::string& b): num
 
 /* Copy */
 
-inline BigRational::BigRational(const BigRational& other): numerator(other.numerator), denominator(other.denominator){}
+inline BigRational::BigRational(const BigRational& other) = default;
 
 inline BigRational& BigRational::operator=(const BigRational& rhs) {
     if (this != &rhs)
@@ -1006,6 +4989,25 @@ inline BigRational& BigRational::operator=(const BigRational& rhs) {
     return *this;
 }
 
+/* Move */
+
+inline BigRational::BigRational(BigRational&& other) noexcept
+    : numerator(std::move(other.numerator)), denominator(std::move(other.denominator))
+{
+    // leave a valid 0/1 behind
+    other.denominator = BigInteger(1);
+}
+
+inline BigRational& BigRational::operator=(BigRational&& rhs) noexcept {
+    if (this != &rhs)
+    {
+        numerator = std::move(rhs.numerator);
+        denominator = std::move(rhs.denominator);
+        rhs.denominator = BigInteger(1);
+    }
+    return *this;
+}
+
 /* Unary operators */
 
 inline const BigRational& BigRational::operator+() const
@@ -1013,110 +5015,149 @@ inline const BigRational& BigRational::operator+() const
     return *this;
 }
 
-inline BigRational BigRational::operator-() const
+inline BigRational BigRational::operator-() const&
 {
     BigRational temp(*this);
-    temp.numerator = -temp.numerator;
-    return temp;
+    return -std::move(temp);
+}
+
+inline BigRational BigRational::operator-() &&
+{
+    numerator = -std::move(numerator);
+    return std::move(*this);
 }
 
 /* Binary arithmetics operators */
 
 inline BigRational& BigRational::operator+=(const BigRational& rhs)
 {
-    // (a/b) + (c/d) = (a*d + b*c) / (b*d)
-    numerator = numerator * rhs.denominator + rhs.numerator * denominator;
-    denominator = denominator * rhs.denominator;
-    reduce();
+    add(*this, *this, rhs, false);
     return *this;
 }
 
-inline BigRational operator+(BigRational lhs, const BigRational& rhs)
+inline BigRational operator+(const BigRational& lhs, const BigRational& rhs)
+{
+    BigRational result;
+    BigRational::add(result, lhs, rhs, false);
+    return result;
+}
+
+inline BigRational operator+(BigRational&& lhs, const BigRational& rhs)
 {
     lhs += rhs;
-    return lhs;
+    return std::move(lhs);
+}
+
+inline BigRational operator+(const BigRational& lhs, BigRational&& rhs)
+{
+    rhs += lhs;
+    return std::move(rhs);
+}
+
+inline BigRational operator+(BigRational&& lhs, BigRational&& rhs)
+{
+    lhs += rhs;
+    return std::move(lhs);
 }
 
 inline BigRational& BigRational::operator-=(const BigRational& rhs)
 {
-    // (a/b) - (c/d) = (a*d - b*c) / (b*d)
-    numerator = numerator * rhs.denominator - rhs.numerator * denominator;
-    denominator = denominator * rhs.denominator;
-    reduce();
+    add(*this, *this, rhs, true);
     return *this;
 }
 
-inline BigRational operator-(BigRational lhs, const BigRational& rhs)
+inline BigRational operator-(const BigRational& lhs, const BigRational& rhs)
+{
+    BigRational result;
+    BigRational::add(result, lhs, rhs, true);
+    return result;
+}
+
+inline BigRational operator-(BigRational&& lhs, const BigRational& rhs)
 {
     lhs -= rhs;
-    return lhs;
+    return std::move(lhs);
+}
+
+inline BigRational operator-(const BigRational& lhs, BigRational&& rhs)
+{
+    // lhs - rhs = -(rhs - lhs)
+    rhs -= lhs;
+    return -std::move(rhs);
+}
+
+inline BigRational operator-(BigRational&& lhs, BigRational&& rhs)
+{
+    lhs -= rhs;
+    return std::move(lhs);
 }
 
 inline BigRational& BigRational::operator*=(const BigRational& rhs)
 {
-    // (a/b) * (c/d) = (a*c) / (b*d)
-    numerator = numerator * rhs.numerator;
-    denominator = denominator * rhs.denominator;
-    reduce();
+    multiply(*this, *this, rhs, false);
     return *this;
 }
 
-inline BigRational operator*(BigRational lhs, const BigRational& rhs)
+inline BigRational operator*(const BigRational& lhs, const BigRational& rhs)
+{
+    BigRational result;
+    BigRational::multiply(result, lhs, rhs, false);
+    return result;
+}
+
+inline BigRational operator*(BigRational&& lhs, const BigRational& rhs)
 {
     lhs *= rhs;
-    return lhs;
+    return std::move(lhs);
+}
+
+inline BigRational operator*(const BigRational& lhs, BigRational&& rhs)
+{
+    rhs *= lhs;
+    return std::move(rhs);
+}
+
+inline BigRational operator*(BigRational&& lhs, BigRational&& rhs)
+{
+    lhs *= rhs;
+    return std::move(lhs);
 }
 
 inline BigRational& BigRational::operator/=(const BigRational& rhs)
 {
-    // (a/b) / (c/d) = (a*d) / (b*c)
-    if (rhs.numerator == BigInteger(0))
-    {
-        throw std::logic_error("zero division");
-    }
-    numerator = numerator * rhs.denominator;
-    denominator = denominator * rhs.numerator;
-    reduce();
+    multiply(*this, *this, rhs, true);
     return *this;
 }
 
-inline BigRational operator/(BigRational lhs, const BigRational& rhs)
+inline BigRational operator/(const BigRational& lhs, const BigRational& rhs)
+{
+    BigRational result;
+    BigRational::multiply(result, lhs, rhs, true);
+    return result;
+}
+
+inline BigRational operator/(BigRational&& lhs, const BigRational& rhs)
 {
     lhs /= rhs;
-    return lhs;
+    return std::move(lhs);
 }
 
 /* Logical operators */
 
 inline std::strong_ordering operator<=>(const BigRational& lhs, const BigRational& rhs)
 {
-    // lhs < rhs  <->  lhs.numerator * rhs.denominator < rhs.numerator * lhs.denominator
-
-    BigInteger left_cross = lhs.numerator * rhs.denominator;
-    BigInteger right_cross = rhs.numerator * lhs.denominator;
-
-    if (left_cross == right_cross)
-    {
-        return std::strong_ordering::equal;
-    }
-    else if (left_cross < right_cross)
-    {
-        return std::strong_ordering::less;
-    }
-    else
-    {
-        return std::strong_ordering::greater;
-    }
+    return BigRational::compare(lhs.numerator, lhs.denominator, rhs.numerator, rhs.denominator);
 }
 
 inline bool operator==(const BigRational& lhs, const BigRational& rhs)
 {
-    return (lhs <=> rhs) == std::strong_ordering::equal;
+    // lowest terms with a positive denominator are unique
+    return lhs.numerator == rhs.numerator && lhs.denominator == rhs.denominator;
 }
 
 inline bool operator!=(const BigRational& lhs, const BigRational& rhs)
 {
-    return (lhs <=> rhs) != std::strong_ordering::equal;
+    return !(lhs == rhs);
 }
 
 inline bool operator<(const BigRational& lhs, const BigRational& rhs)
@@ -1149,7 +5190,7 @@ inline std::ostream& operator<<(std::ostream& lhs, const BigRational& rhs)
     BigInteger abs_number = rhs.numerator;
     bool negative = false;
 
-    if (abs_number < BigInteger(0))
+    if (abs_number.sign() < 0)
     {
         negative = true;
         abs_number = -abs_number;
@@ -1162,7 +5203,7 @@ inline std::ostream& operator<<(std::ostream& lhs, const BigRational& rhs)
 
     lhs << abs_number;
 
-    if (rhs.denominator != BigInteger(1))
+    if (!rhs.denominator.is_one())
     {
         lhs << "/" << rhs.denominator;
     }
@@ -1202,7 +5243,7 @@ inline std::istream& operator>>(std::istream& lhs, BigRational& rhs)
             return lhs;
         }
 
-        if (den == BigInteger(0))
+        if (den.is_zero())
         {
             lhs.setstate(std::ios::failbit);
             return lhs;
@@ -1228,133 +5269,513 @@ inline std::istream& operator>>(std::istream& lhs, BigRational& rhs)
 
 inline double BigRational::sqrt() const
 {
-    if (numerator < BigInteger(0))
+    if (numerator.sign() < 0)
     {
         throw std::runtime_error("negative number");
     }
 
-    double double_numerator = 0.0;
-    double double_denominator = 0.0;
-
-    try {
-        double_numerator = std::stod(this->numerator.value);
-        double_denominator = std::stod(this->denominator.value);
-    } catch(const std::out_of_range&) {
-        throw std::runtime_error("large number");
+    auto [mantissa, exponent] = frexp();
+    if (exponent % 2 != 0)
+    {
+        mantissa *= 2;
+        --exponent;
     }
+    return BigInteger::scaleMantissa(std::sqrt(mantissa), exponent / 2);
+}
+
+inline double BigRational::to_double() const
+{
+    auto [mantissa, exponent] = frexp();
+    return BigInteger::scaleMantissa(mantissa, exponent);
+}
 
-    if (std::isinf(double_numerator) || std::isinf(double_denominator) || double_denominator == 0.0)
+inline std::pair<double, int64_t> BigRational::frexp() const
+{
+    // a quotient of at least two bits more than a double holds, with its lowest bit set for a nonzero
+    // remainder, rounds like the exact value
+    if (numerator.is_zero())
     {
-        throw std::runtime_error("large number");
+        return {0.0, 0};
     }
 
-    double number = double_numerator / double_denominator;
-    if (number < 0.0)
+    int64_t shift = std::numeric_limits<double>::digits + 2
+        - (static_cast<int64_t>(numerator.bit_length()) - static_cast<int64_t>(denominator.bit_length()));
+    BigInteger magnitude = numerator.negative ? -numerator : numerator;
+    auto [quotient, remainder] = shift >= 0 ? (magnitude << shift).divmod(denominator)
+                                            : magnitude.divmod(denominator << static_cast<size_t>(-shift));
+    if (!remainder.is_zero())
     {
-        throw std::runtime_error("negative number");
+        quotient <<= 1;
+        quotient.limbs[0] |= 1;
+        ++shift;
     }
 
-    double result = std::sqrt(number);
-    if (std::isinf(result))
+    quotient.negative = numerator.negative;
+    auto [mantissa, exponent] = quotient.frexp();
+    return {mantissa, exponent - shift};
+}
+
+inline std::vector<uint8_t> BigRational::serialize() const
+{
+    std::vector<uint8_t> record = {BigInteger::record_version};
+    numerator.appendRecordBody(record);
+    denominator.appendRecordBody(record);
+    return record;
+}
+
+inline void BigRational::serialize(std::ostream& out) const
+{
+    std::vector<uint8_t> record = serialize();
+    out.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+}
+
+inline BigRational BigRational::deserialize(std::span<const uint8_t> record, size_t* consumed)
+{
+    size_t offset = 0;
+    BigRational result = readRecord([&](uint8_t* destination, size_t count)
     {
-        throw std::runtime_error("large number");
-    }
+        if (count > record.size() - offset)
+        {
+            throw std::invalid_argument("truncated record");
+        }
+        std::copy_n(record.data() + offset, count, destination);
+        offset += count;
+    });
 
+    if (consumed != nullptr)
+    {
+        *consumed = offset;
+    }
+    else if (offset != record.size())
+    {
+        throw std::invalid_argument("malformed record");
+    }
     return result;
 }
 
+inline BigRational BigRational::deserialize(std::istream& in)
+{
+    return readRecord([&in](uint8_t* destination, size_t count)
+    {
+        if (!in.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(count)))
+        {
+            throw std::invalid_argument("truncated record");
+        }
+    });
+}
+
 #if SUPPORT_MORE_OPS == 1
 
 inline BigInteger BigRational::isqrt() const
 {
-    if (numerator < BigInteger(0))
+    if (numerator.sign() < 0)
     {
         throw std::runtime_error("negative number");
     }
 
-    if (numerator == BigInteger(0))
+    // floor(sqrt(x)) == floor(sqrt(floor(x))) for x >= 0
+    return (numerator / denominator).isqrt();
+}
+
+#endif
+
+/* Assistants */
+
+inline void BigRational::add(BigRational& result, const BigRational& lhs, const BigRational& rhs, bool subtract)
+{
+    // (a/b) +- (c/d) with both in lowest terms, Henrici's algorithm (Knuth, TAOCP 4.5.1):
+    // with g = gcd(b, d) and t = a*(d/g) +- c*(b/g), the result is (t/h) / ((b/g)*(d/h)) for
+    // h = gcd(t, g), so the only gcds are over the denominators and the small g;
+    // result may alias lhs or rhs
+    const BigInteger& a = lhs.numerator;
+    const BigInteger& b = lhs.denominator;
+    const BigInteger& c = rhs.numerator;
+    const BigInteger& d = rhs.denominator;
+
+    BigInteger g = BigInteger::gcd(b, d);
+    if (g.is_one())
     {
-        return BigInteger(0);
+        // a*d +- b*c is then coprime to b*d already
+        BigInteger numerator = a * d;
+        BigInteger cross = b * c;
+        numerator.addMagnitude(cross, subtract != cross.negative);
+        result.denominator = b * d;
+        result.numerator = std::move(numerator);
+        return;
+    }
+
+    BigInteger b_reduced = b.divexact(g);
+    BigInteger numerator = a * d.divexact(g);
+    BigInteger cross = c * b_reduced;
+    numerator.addMagnitude(cross, subtract != cross.negative);
+
+    if (numerator.is_zero())
+    {
+        result.numerator = BigInteger(0);
+        result.denominator = BigInteger(1);
+        return;
+    }
+
+    BigInteger h = BigInteger::gcd(numerator, g);
+    result.denominator = h.is_one() ? b_reduced * d : b_reduced * d.divexact(h);
+    result.numerator = h.is_one() ? std::move(numerator) : numerator.divexact(h);
+}
+
+inline void BigRational::multiply(BigRational& result, const BigRational& lhs, const BigRational& rhs, bool divide)
+{
+    // (a/b) * (c/d) with both in lowest terms, Henrici's algorithm (Knuth, TAOCP 4.5.1): cancelling
+    // gcd(a, d) and gcd(c, b) first leaves a product in lowest terms from smaller factors;
+    // (a/b) / (c/d) is (a/b) * (d/c); result may alias lhs or rhs
+    const BigInteger& c = divide ? rhs.denominator : rhs.numerator;
+    const BigInteger& d = divide ? rhs.numerator : rhs.denominator;
+
+    if (divide && d.is_zero())
+    {
+        throw std::logic_error("zero division");
+    }
+    if (lhs.numerator.is_zero() || c.is_zero())
+    {
+        result.numerator = BigInteger(0);
+        result.denominator = BigInteger(1);
+        return;
     }
 
-    // searching for x^2 <= numerator/denominator <= (x + 1)^2
-    // -> x^2 * denominator <= numerator <= (x + 1)^2 * denominator
-    // -> binary search
+    auto cancel = [](const BigInteger& x, const BigInteger& divisor)
+    {
+        return divisor.is_one() ? x : x.divexact(divisor);
+    };
 
-    BigInteger low(0);
-    BigInteger high = numerator;
-    BigInteger one(1);
+    BigInteger g1 = BigInteger::gcd(lhs.numerator, d);
+    BigInteger g2 = BigInteger::gcd(c, lhs.denominator);
+    BigInteger numerator = cancel(lhs.numerator, g1) * cancel(c, g2);
+    BigInteger denominator = cancel(lhs.denominator, g2) * cancel(d, g1);
 
-    BigInteger result(0);
+    if (denominator.negative)
+    {
+        numerator.negative = !numerator.negative;
+        denominator.negative = false;
+    }
+    result.numerator = std::move(numerator);
+    result.denominator = std::move(denominator);
+}
 
-    while (low <= high)
+inline std::strong_ordering BigRational::compare(const BigInteger& a, const BigInteger& b, const BigInteger& c, const BigInteger& d)
+{
+    // a/b <=> c/d for positive b and d, that is a*d <=> c*b: by the signs, by the bit lengths of the
+    // cross products, by bounds from the leading 62 bits of each factor, and only then exactly
+    if (a.sign() != c.sign() || a.is_zero())
     {
-        BigInteger mid = (low + high) / BigInteger(2);
+        return a.sign() <=> c.sign();
+    }
 
-        BigInteger left = mid * mid * denominator;
+    // |a|*d has la + ld - 1 or la + ld bits
+    size_t left = a.bit_length() + d.bit_length();
+    size_t right = c.bit_length() + b.bit_length();
+    std::strong_ordering magnitude = left > right ? std::strong_ordering::greater : std::strong_ordering::less;
 
-        if (left == numerator)
+    if (left + 1 >= right && right + 1 >= left)
+    {
+        // x = m * 2^e + r with m the leading 62 bits and 0 <= r < 2^e, so a product of two factors
+        // lies in [m1 * m2, (m1 + [e1 > 0]) * (m2 + [e2 > 0])) * 2^(e1 + e2), or is m1 * m2 exactly
+        using uint128 = unsigned __int128;
+        struct Bounds
         {
-            return mid;
+            uint128 low;
+            uint128 high;
+            size_t exponent;
+        };
+        auto bounds = [](const BigInteger& x, const BigInteger& y)
+        {
+            size_t x_exponent = x.bit_length() > 62 ? x.bit_length() - 62 : 0;
+            size_t y_exponent = y.bit_length() > 62 ? y.bit_length() - 62 : 0;
+            uint128 x_bits = x.bitsFrom(x_exponent);
+            uint128 y_bits = y.bitsFrom(y_exponent);
+            bool exact = (x_exponent == 0 && y_exponent == 0);
+            return Bounds{x_bits * y_bits, (x_bits + (x_exponent > 0)) * (y_bits + (y_exponent > 0)) + exact, x_exponent + y_exponent};
+        };
+
+        Bounds p = bounds(a, d);
+        Bounds q = bounds(c, b);
+
+        // the product with the larger exponent is within 2^126 after aligning
+        size_t common = std::min(p.exponent, q.exponent);
+        p.low <<= p.exponent - common;
+        p.high <<= p.exponent - common;
+        q.low <<= q.exponent - common;
+        q.high <<= q.exponent - common;
+
+        if (p.low >= q.high)
+        {
+            magnitude = std::strong_ordering::greater;
         }
-        else if (left < numerator)
+        else if (q.low >= p.high)
         {
-            result = mid;
-            low = mid + one;
+            magnitude = std::strong_ordering::less;
         }
         else
         {
-            high = mid - one;
+            BigInteger left_cross = a * d;
+            BigInteger right_cross = c * b;
+            int cmp = BigInteger::compareLimbs(left_cross.limbs.data(), left_cross.limbs.size(), right_cross.limbs.data(), right_cross.limbs.size());
+            magnitude = cmp <=> 0;
         }
     }
 
-    return result;
+    return a.sign() > 0 ? magnitude : 0 <=> magnitude;
 }
 
-#endif
-
-/* Assistants */
-
-inline BigInteger BigRational::gcd(const BigInteger& x, const BigInteger& y) // euclidean
+template <typename Read>
+inline BigRational BigRational::readRecord(Read read)
 {
-    BigInteger a = x;
-    BigInteger b = y;
-
-    if (a < BigInteger(0))
+    uint8_t version = 0;
+    read(&version, 1);
+    if (version != BigInteger::record_version)
     {
-        a = -a;
+        throw std::invalid_argument("record version");
     }
 
-    if (b < BigInteger(0))
+    BigRational result;
+    result.numerator = BigInteger::readRecordBody(read);
+    result.denominator = BigInteger::readRecordBody(read);
+    if (result.denominator.sign() <= 0)
     {
-        b = -b;
+        throw std::invalid_argument("malformed record");
     }
 
-    while (b != BigInteger(0))
-    {
-        BigInteger remained = a % b;
-        a = b;
-        b = remained;
-    }
-    return a;
+    result.reduce();
+    return result;
 }
 
 inline void BigRational::reduce()
 {
-    if (numerator == BigInteger(0))
+    if (numerator.is_zero())
     {
         denominator = BigInteger(1);
         return;
     }
 
-    BigInteger divisor = gcd(numerator, denominator);
+    BigInteger divisor = BigInteger::gcd(numerator, denominator);
 
-    numerator /= divisor;
-    denominator /= divisor;
+    numerator = numerator.divexact(divisor);
+    denominator = denominator.divexact(divisor);
 
-    if (denominator < BigInteger(0))
+    if (denominator.sign() < 0)
     {
         numerator = -numerator;
         denominator = -denominator;
     }
+}
+
+/*
+ * BigRationalAccumulator
+ */
+
+// A rational for accumulation loops that defers the reduction to lowest terms: the operators work on
+// the raw numerator and denominator, which are reduced by normalize(), value() and output, or once the
+// denominator has grown by growth_threshold limbs since the last reduction. Comparisons are exact on
+// unreduced values.
+
+class BigRationalAccumulator
+{
+public:
+    // constructors
+    BigRationalAccumulator();
+    BigRationalAccumulator(const BigRational& value);
+
+    // binary arithmetics operators
+    BigRationalAccumulator& operator+=(const BigRationalAccumulator& rhs);
+    BigRationalAccumulator& operator-=(const BigRationalAccumulator& rhs);
+    BigRationalAccumulator& operator*=(const BigRationalAccumulator& rhs);
+    BigRationalAccumulator& operator/=(const BigRationalAccumulator& rhs);
+
+    // normalization
+    void normalize();
+    BigRational value() const;      // in lowest terms
+
+    // growth of the denominator in limbs after which the operators reduce on their own
+    static inline size_t growth_threshold = 32;
+
+private:
+    // realization
+    BigInteger numerator;
+    BigInteger denominator;     // positive, not necessarily coprime to the numerator
+    size_t reduced_size;        // limbs of the denominator at the last reduction
+
+    // friends
+    friend std::ostream& operator<<(std::ostream& lhs, const BigRationalAccumulator& rhs);
+
+    friend BigRationalAccumulator operator+(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+    friend BigRationalAccumulator operator-(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+    friend BigRationalAccumulator operator*(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+    friend BigRationalAccumulator operator/(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+
+    friend std::strong_ordering operator<=>(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+    friend bool operator==(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs);
+
+    // assistants
+    void add(const BigRationalAccumulator& rhs, bool subtract);
+    void multiply(const BigRationalAccumulator& rhs, bool divide);
+    void reduceIfGrown();
+};
+
+/* Constructors */
+
+inline BigRationalAccumulator::BigRationalAccumulator() : numerator(0), denominator(1), reduced_size(1) {}
+
+inline BigRationalAccumulator::BigRationalAccumulator(const BigRational& value)
+    : numerator(value.numerator), denominator(value.denominator), reduced_size(value.denominator.limbs.size())
+{
+}
+
+/* Binary arithmetics operators */
+
+inline BigRationalAccumulator& BigRationalAccumulator::operator+=(const BigRationalAccumulator& rhs)
+{
+    add(rhs, false);
+    return *this;
+}
+
+inline BigRationalAccumulator operator+(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    BigRationalAccumulator result = lhs;
+    result += rhs;
+    return result;
+}
+
+inline BigRationalAccumulator& BigRationalAccumulator::operator-=(const BigRationalAccumulator& rhs)
+{
+    add(rhs, true);
+    return *this;
+}
+
+inline BigRationalAccumulator operator-(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    BigRationalAccumulator result = lhs;
+    result -= rhs;
+    return result;
+}
+
+inline BigRationalAccumulator& BigRationalAccumulator::operator*=(const BigRationalAccumulator& rhs)
+{
+    multiply(rhs, false);
+    return *this;
+}
+
+inline BigRationalAccumulator operator*(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    BigRationalAccumulator result = lhs;
+    result *= rhs;
+    return result;
+}
+
+inline BigRationalAccumulator& BigRationalAccumulator::operator/=(const BigRationalAccumulator& rhs)
+{
+    multiply(rhs, true);
+    return *this;
+}
+
+inline BigRationalAccumulator operator/(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    BigRationalAccumulator result = lhs;
+    result /= rhs;
+    return result;
+}
+
+/* Normalization */
+
+inline void BigRationalAccumulator::normalize()
+{
+    BigInteger divisor = BigInteger::gcd(numerator, denominator);
+    if (!divisor.is_one())
+    {
+        numerator = numerator.divexact(divisor);
+        denominator = denominator.divexact(divisor);
+    }
+    reduced_size = denominator.limbs.size();
+}
+
+inline BigRational BigRationalAccumulator::value() const
+{
+    BigRationalAccumulator reduced = *this;
+    reduced.normalize();
+
+    BigRational result;
+    result.numerator = std::move(reduced.numerator);
+    result.denominator = std::move(reduced.denominator);
+    return result;
+}
+
+/* Logical operators */
+
+inline std::strong_ordering operator<=>(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    return BigRational::compare(lhs.numerator, lhs.denominator, rhs.numerator, rhs.denominator);
+}
+
+inline bool operator==(const BigRationalAccumulator& lhs, const BigRationalAccumulator& rhs)
+{
+    return (lhs <=> rhs) == 0;
+}
+
+/* Friends */
+
+inline std::ostream& operator<<(std::ostream& lhs, const BigRationalAccumulator& rhs)
+{
+    return lhs << rhs.value();
+}
+
+/* Assistants */
+
+inline void BigRationalAccumulator::add(const BigRationalAccumulator& rhs, bool subtract)
+{
+    // (a/b) +- (c/d) = (a*d +- b*c) / (b*d), just a*d +- c over a shared denominator; rhs may alias *this
+    if (denominator == rhs.denominator)
+    {
+        BigInteger addend = rhs.numerator;
+        numerator.addMagnitude(addend, subtract != addend.negative);
+    }
+    else
+    {
+        BigInteger cross = denominator * rhs.numerator;
+        numerator *= rhs.denominator;
+        numerator.addMagnitude(cross, subtract != cross.negative);
+        denominator *= rhs.denominator;
+    }
+
+    reduceIfGrown();
+}
+
+inline void BigRationalAccumulator::multiply(const BigRationalAccumulator& rhs, bool divide)
+{
+    // (a/b) * (c/d) = (a*c) / (b*d), (a/b) / (c/d) = (a*d) / (b*c); rhs may alias *this
+    BigInteger c = divide ? rhs.denominator : rhs.numerator;
+    BigInteger d = divide ? rhs.numerator : rhs.denominator;
+
+    if (divide && d.is_zero())
+    {
+        throw std::logic_error("zero division");
+    }
+
+    numerator *= c;
+    denominator *= d;
+    if (denominator.negative)
+    {
+        numerator = -std::move(numerator);
+        denominator.negative = false;
+    }
+
+    reduceIfGrown();
+}
+
+inline void BigRationalAccumulator::reduceIfGrown()
+{
+    if (numerator.is_zero())
+    {
+        denominator = BigInteger(1);
+        reduced_size = 1;
+    }
+    else if (denominator.limbs.size() > reduced_size + growth_threshold)
+    {
+        normalize();
+    }
 }
\ No newline at end of file
@@ -26,6 +26,39 @@ protected:
 
     BigInteger _neg_large1 = BigInteger("-123456789012345678901234567890");
     BigInteger _neg_large2 = BigInteger("-987654321098765432109876543210");
+
+    std::mt19937_64 _rng = std::mt19937_64(42);
+
+    // thresholds a test may lower, put back even when an assertion returns early
+    const size_t _karatsuba_threshold = BigInteger::karatsuba_threshold;
+    const size_t _toom3_threshold = BigInteger::toom3_threshold;
+    const size_t _toom4_threshold = BigInteger::toom4_threshold;
+    const size_t _ntt_threshold = BigInteger::ntt_threshold;
+    const size_t _burnikel_ziegler_threshold = BigInteger::burnikel_ziegler_threshold;
+    const size_t _half_gcd_threshold = BigInteger::half_gcd_threshold;
+    const size_t _radix_threshold = BigInteger::radix_threshold;
+
+    void TearDown() override
+    {
+        BigInteger::karatsuba_threshold = _karatsuba_threshold;
+        BigInteger::toom3_threshold = _toom3_threshold;
+        BigInteger::toom4_threshold = _toom4_threshold;
+        BigInteger::ntt_threshold = _ntt_threshold;
+        BigInteger::burnikel_ziegler_threshold = _burnikel_ziegler_threshold;
+        BigInteger::half_gcd_threshold = _half_gcd_threshold;
+        BigInteger::radix_threshold = _radix_threshold;
+    }
+
+    BigInteger random_number(size_t digits, bool is_signed = true)
+    {
+        std::string str(digits, '0');
+        for (char& c : str)
+        {
+            c = static_cast<char>('0' + _rng() % 10);
+        }
+        str[0] = static_cast<char>('1' + _rng() % 9);
+        return BigInteger((is_signed && _rng() % 2 ? "-" : "") + str);
+    }
 };
 
 TEST_F(TestBigInteger, TestConstructor)
@@ -47,6 +80,9 @@ TEST_F(TestBigInteger, TestConstructor)
     
     BigInteger neg_from_int(-67890);
     ASSERT_EQ(neg_from_int, _neg_num2);
+
+    BigInteger min_from_int(std::numeric_limits<int64_t>::min());
+    ASSERT_EQ(min_from_int, BigInteger("-9223372036854775808"));
 }
 
 TEST_F(TestBigInteger, TestUnary)
@@ -147,6 +183,37 @@ TEST_F(TestBigInteger, TestInputOutput)
         input_stream >> num;
         ASSERT_FALSE(input_stream.good());
     }
+
+    {
+        std::istringstream input_stream("-0xFFffffffffffffffff 777 0 g");
+        BigInteger a;
+        BigInteger b;
+        BigInteger c;
+        input_stream >> std::hex >> a >> std::oct >> b >> std::hex >> c;
+        ASSERT_EQ(a, BigInteger("-4722366482869645213695"));
+        ASSERT_EQ(b, BigInteger(511));
+        ASSERT_EQ(c, _pos_zero);
+        input_stream >> a;
+        ASSERT_TRUE(input_stream.fail());
+    }
+
+    {
+        // a 0x without hexadecimal digits is a zero followed by the x
+        std::istringstream input_stream("0xg -0X 0x1f");
+        BigInteger a;
+        BigInteger b;
+        BigInteger c;
+        input_stream >> std::hex >> a;
+        ASSERT_EQ(a, _pos_zero);
+        ASSERT_EQ(input_stream.get(), 'x');
+        input_stream.ignore(1);
+        input_stream >> b;
+        ASSERT_EQ(b, _pos_zero);
+        ASSERT_EQ(input_stream.get(), 'X');
+        input_stream >> c;
+        ASSERT_EQ(c, BigInteger(31));
+        ASSERT_FALSE(input_stream.fail());
+    }
 }
 
 #endif
@@ -170,6 +237,11 @@ TEST_F(TestBigInteger, TestArithmeticOperators)
         BigInteger sum = _pos_large1 + _pos_large2;
         ASSERT_EQ(sum, BigInteger("1111111110111111111011111111100"));
     }
+    {
+        // carry across a limb boundary: (2^64 - 1) + 1 = 2^64
+        BigInteger sum = BigInteger("18446744073709551615") + _pos_one;
+        ASSERT_EQ(sum, BigInteger("18446744073709551616"));
+    }
 
     // Subtraction
     {
@@ -194,6 +266,10 @@ TEST_F(TestBigInteger, TestArithmeticOperators)
         BigInteger prod = _pos_num1 * _pos_zero;
         ASSERT_EQ(prod, _pos_zero);
     }
+    {
+        BigInteger prod = _pos_large1 * _neg_large2;
+        ASSERT_EQ(prod, BigInteger("-121932631137021795226185032733622923332237463801111263526900"));
+    }
 
     // Division
     {
@@ -218,6 +294,794 @@ TEST_F(TestBigInteger, TestArithmeticOperators)
         BigInteger rem = _pos_large2 % _pos_large1;
         ASSERT_EQ(rem, BigInteger("9000000000900000000090"));
     }
+    {
+        BigInteger rem = _neg_large2 % _pos_large1;
+        ASSERT_EQ(rem, BigInteger("-9000000000900000000090"));
+    }
+}
+
+TEST_F(TestBigInteger, TestNativeOperators)
+{
+    ASSERT_EQ(_pos_large1 + 1, _pos_large1 + BigInteger(1));
+    ASSERT_EQ(_neg_large1 - 7, _neg_large1 - BigInteger(7));
+    ASSERT_EQ(7 - _neg_large1, BigInteger(7) - _neg_large1);
+    ASSERT_EQ(_pos_large2 * -3, _pos_large2 * BigInteger(-3));
+    ASSERT_EQ(_neg_large2 / 10, _neg_large2 / BigInteger(10));
+    ASSERT_EQ(_neg_large2 % 10, _neg_large2 % BigInteger(10));
+    ASSERT_EQ(BigInteger(-1) + 1, _pos_zero);
+    ASSERT_EQ(BigInteger(5) - 7, BigInteger(-2));
+    ASSERT_EQ(BigInteger(-5) % 3, BigInteger(-2));
+    ASSERT_EQ(BigInteger(INT64_MIN) - INT64_MIN, _pos_zero);
+    ASSERT_EQ(BigInteger(1) * UINT64_MAX, BigInteger("18446744073709551615"));
+    ASSERT_EQ(BigInteger("18446744073709551615") + 1u, BigInteger("18446744073709551616"));
+    ASSERT_EQ(BigInteger("18446744073709551616") - 1u, BigInteger("18446744073709551615"));
+    ASSERT_THROW(_pos_large1 / 0, std::logic_error);
+    ASSERT_THROW(_pos_large1 % 0, std::logic_error);
+
+    BigInteger value = _pos_large1;
+    value += 5;
+    value -= 2;
+    value *= 4;
+    value /= 2;
+    value %= 1000;
+    ASSERT_EQ(value, ((_pos_large1 + BigInteger(3)) * BigInteger(2)) % BigInteger(1000));
+
+    ASSERT_TRUE(_pos_large1 > 0);
+    ASSERT_TRUE(0 > _neg_large1);
+    ASSERT_TRUE(_pos_zero == 0);
+    ASSERT_TRUE(BigInteger(-3) < -2);
+    ASSERT_TRUE(BigInteger(-3) <= -3);
+    ASSERT_TRUE(BigInteger(-3) != 3);
+    ASSERT_TRUE(BigInteger("18446744073709551615") == UINT64_MAX);
+    ASSERT_TRUE(BigInteger("18446744073709551616") > UINT64_MAX);
+
+    ASSERT_TRUE(_pos_zero.is_zero());
+    ASSERT_FALSE(_pos_large1.is_zero());
+    ASSERT_TRUE(BigInteger(1).is_one());
+    ASSERT_FALSE(BigInteger(-1).is_one());
+    ASSERT_TRUE(_pos_zero.is_even());
+    ASSERT_TRUE(BigInteger(-4).is_even());
+    ASSERT_FALSE(BigInteger("18446744073709551617").is_even());
+    ASSERT_EQ(_pos_zero.sign(), 0);
+    ASSERT_EQ(_pos_large1.sign(), 1);
+    ASSERT_EQ(_neg_large1.sign(), -1);
+}
+
+TEST_F(TestBigInteger, TestBitwiseOperators)
+{
+    BigInteger two64("18446744073709551616");
+    BigInteger a("340282366920938463463374607431768211457");     // 2^128 + 1
+    BigInteger b("-18446744073709551621");                       // -(2^64 + 5)
+
+    ASSERT_EQ(a & b, a);
+    ASSERT_EQ(a | b, BigInteger("-18446744073709551621"));
+    ASSERT_EQ(a ^ b, BigInteger("-340282366920938463481821351505477763078"));
+    ASSERT_EQ(BigInteger(-6) & BigInteger(-4), BigInteger(-8));
+    ASSERT_EQ(BigInteger(-6) | BigInteger(5), BigInteger(-1));
+    ASSERT_EQ(BigInteger(12) ^ BigInteger(10), BigInteger(6));
+    ASSERT_EQ(_pos_large1 & _pos_zero, _pos_zero);
+    ASSERT_EQ(_neg_large1 ^ _neg_large1, _pos_zero);
+    ASSERT_EQ(~_pos_zero, BigInteger(-1));
+    ASSERT_EQ(~_neg_large2, _pos_large2 - BigInteger(1));
+
+    ASSERT_EQ(BigInteger(1) << 64, two64);
+    ASSERT_EQ(two64 >> 64, BigInteger(1));
+    ASSERT_EQ(_neg_large1 << 3, _neg_large1 * BigInteger(8));
+    ASSERT_EQ(BigInteger(-7) >> 1, BigInteger(-4));
+    ASSERT_EQ(BigInteger(-8) >> 2, BigInteger(-2));
+    ASSERT_EQ(BigInteger(-1) >> 1000, BigInteger(-1));
+    ASSERT_EQ(_pos_large1 >> 1000, _pos_zero);
+    ASSERT_EQ(-two64 >> 65, BigInteger(-1));
+
+    BigInteger value = _pos_large2;
+    value <<= 130;
+    value >>= 130;
+    ASSERT_EQ(value, _pos_large2);
+
+    ASSERT_EQ(_pos_zero.bit_length(), 0u);
+    ASSERT_EQ(two64.bit_length(), 65u);
+    ASSERT_EQ(b.bit_length(), 65u);
+    ASSERT_TRUE(a.test_bit(128));
+    ASSERT_FALSE(a.test_bit(64));
+    ASSERT_TRUE(BigInteger(-4).test_bit(2));
+    ASSERT_FALSE(BigInteger(-4).test_bit(1));
+    ASSERT_TRUE(BigInteger(-4).test_bit(500));
+    ASSERT_EQ(a.popcount(), 2u);
+    ASSERT_EQ(BigInteger(-7).popcount(), 3u);
+    ASSERT_EQ(two64.trailing_zeros(), 64u);
+    ASSERT_EQ((-two64).trailing_zeros(), 64u);
+    ASSERT_EQ(_pos_zero.trailing_zeros(), 0u);
+}
+
+TEST_F(TestBigInteger, TestConversion)
+{
+    ASSERT_EQ(_pos_zero.to_double(), 0.0);
+    ASSERT_EQ(_neg_num1.to_double(), -12345.0);
+    ASSERT_EQ(_pos_large1.to_double(), 123456789012345678901234567890.0);
+    ASSERT_EQ(_neg_large2.to_long_double(), -987654321098765432109876543210.0L);
+
+    // ties round to even on the 54th bit, anything below breaks them
+    BigInteger two53 = BigInteger(1) << 53;
+    ASSERT_EQ((two53 + 1).to_double(), 9007199254740992.0);
+    ASSERT_EQ((two53 + 3).to_double(), 9007199254740996.0);
+    ASSERT_EQ(((two53 + 1) << 200).to_double(), std::ldexp(1.0, 253));
+    ASSERT_EQ((((two53 + 1) << 200) + 1).to_double(), std::ldexp(9007199254740994.0, 200));
+    ASSERT_EQ(((BigInteger(1) << 64) - 1).to_double(), 18446744073709551616.0);
+
+    BigInteger max = (two53 - 1) << 971;
+    ASSERT_EQ(max.to_double(), std::numeric_limits<double>::max());
+    ASSERT_EQ((-max).to_double(), -std::numeric_limits<double>::max());
+    ASSERT_THROW((max + (BigInteger(1) << 970)).to_double(), std::runtime_error);
+    ASSERT_THROW((BigInteger(1) << 5000).to_double(), std::runtime_error);
+
+    auto [mantissa, exponent] = (BigInteger(3) << 5000).frexp();
+    ASSERT_EQ(mantissa, 0.75);
+    ASSERT_EQ(exponent, 5002);
+    ASSERT_EQ(_neg_one.frexp(), std::make_pair(-0.5, int64_t(1)));
+    ASSERT_EQ(_pos_zero.frexp(), std::make_pair(0.0, int64_t(0)));
+
+    ASSERT_TRUE(BigInteger(INT64_MAX).fits_int64());
+    ASSERT_TRUE(BigInteger(INT64_MIN).fits_int64());
+    ASSERT_FALSE((BigInteger(INT64_MAX) + 1).fits_int64());
+    ASSERT_FALSE((BigInteger(INT64_MIN) - 1).fits_int64());
+    ASSERT_EQ(BigInteger(INT64_MIN).to_int64(), INT64_MIN);
+    ASSERT_EQ(_neg_num2.to_int64(), -67890);
+    ASSERT_EQ(_pos_zero.to_int64(), 0);
+    ASSERT_THROW(_pos_large1.to_int64(), std::runtime_error);
+
+    // the root of a number beyond double is still in range
+    ASSERT_DOUBLE_EQ((BigInteger(1) << 1500).sqrt(), std::ldexp(1.0, 750));
+    ASSERT_DOUBLE_EQ((BigInteger(1) << 1501).sqrt(), std::ldexp(std::sqrt(2.0), 750));
+}
+
+TEST_F(TestBigInteger, TestPowers)
+{
+    BigInteger prime = (BigInteger(1) << 127) - 1;
+    ASSERT_EQ(BigInteger::powmod(_pos_large1, prime - 1, prime), BigInteger(1));
+    ASSERT_EQ(BigInteger::powmod(BigInteger(3), BigInteger(200), BigInteger(1000)), BigInteger(1));
+    ASSERT_EQ(BigInteger::powmod(BigInteger(-2), BigInteger(3), BigInteger(5)), BigInteger(2));
+    ASSERT_EQ(BigInteger::powmod(BigInteger(-2), BigInteger(3), BigInteger(-5)), BigInteger(2));
+    ASSERT_EQ(BigInteger::powmod(_pos_large2, _pos_zero, BigInteger(7)), BigInteger(1));
+    ASSERT_EQ(BigInteger::powmod(_pos_large2, _pos_large1, BigInteger(1)), _pos_zero);
+    ASSERT_THROW(BigInteger::powmod(_pos_large2, BigInteger(2), _pos_zero), std::invalid_argument);
+    ASSERT_THROW(BigInteger::powmod(_pos_large2, BigInteger(-2), BigInteger(7)), std::invalid_argument);
+
+    // long exponents use the widest windows, for odd and even moduli alike
+    BigInteger exponent = (BigInteger(1) << 2000) - 1;
+    BigInteger even = (BigInteger(1) << 130) * BigInteger(3);
+    BigInteger expected(1);
+    BigInteger square = _pos_large1 % even;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        expected = expected * square % even;
+        square = square * square % even;
+    }
+    ASSERT_EQ(BigInteger::powmod(_pos_large1, exponent, even), expected);
+
+    BigInteger odd = even + 1;
+    BigInteger high = (exponent >> 1000) << 1000;
+    BigInteger low = exponent - high;
+    ASSERT_EQ(BigInteger::powmod(_pos_large1, exponent, odd),
+              BigInteger::powmod(_pos_large1, high, odd) * BigInteger::powmod(_pos_large1, low, odd) % odd);
+
+    ASSERT_EQ(BigInteger::pow(BigInteger(2), 200), BigInteger(1) << 200);
+    ASSERT_EQ(BigInteger::pow(BigInteger(-3), 3), BigInteger(-27));
+    ASSERT_EQ(BigInteger::pow(_neg_large1, 0), BigInteger(1));
+    ASSERT_EQ(BigInteger::pow(_neg_large1, 2), _neg_large1 * _neg_large1);
+}
+
+TEST_F(TestBigInteger, TestMontgomery)
+{
+    // 2^127 - 1 is prime, Fermat's little theorem holds for every base
+    BigInteger prime = (BigInteger(1) << 127) - 1;
+    MontgomeryContext context(prime);
+
+    ASSERT_EQ(context.modulus(), prime);
+    ASSERT_EQ(context.from_montgomery(context.one()), BigInteger(1));
+    ASSERT_EQ(context.from_montgomery(context.to_montgomery(_pos_large1)), _pos_large1 % prime);
+    ASSERT_EQ(context.from_montgomery(context.to_montgomery(_neg_large1)), _neg_large1 % prime + prime);
+
+    BigInteger a = context.to_montgomery(_pos_large1);
+    BigInteger b = context.to_montgomery(_neg_large2);
+    ASSERT_EQ(context.from_montgomery(context.multiply(a, b)), (_pos_large1 * _neg_large2) % prime + prime);
+    ASSERT_EQ(context.from_montgomery(context.square(a)), (_pos_large1 * _pos_large1) % prime);
+    ASSERT_EQ(context.from_montgomery(context.power(a, prime - 1)), BigInteger(1));
+    ASSERT_EQ(context.power(a, _pos_zero), context.one());
+
+    // multi-limb modulus with every limb full
+    BigInteger modulus = (BigInteger(1) << 256) - 1;
+    MontgomeryContext wide(modulus);
+    BigInteger x = wide.to_montgomery(_pos_large2);
+    BigInteger expected(1);
+    for (int i = 0; i < 65; i++)
+    {
+        expected = expected * _pos_large2 % modulus;
+    }
+    ASSERT_EQ(wide.from_montgomery(wide.power(x, BigInteger(65))), expected);
+
+    ASSERT_THROW(MontgomeryContext(BigInteger(10)), std::invalid_argument);
+    ASSERT_THROW(MontgomeryContext(BigInteger(-7)), std::invalid_argument);
+    ASSERT_THROW(context.power(a, BigInteger(-1)), std::invalid_argument);
+}
+
+TEST_F(TestBigInteger, TestBarrett)
+{
+    // an even modulus, 2^70 * 3 * (2^127 - 1)
+    BigInteger modulus = (BigInteger(3) << 70) * ((BigInteger(1) << 127) - 1);
+    BigInteger a = _pos_large1 * _pos_large2;
+    BigInteger b = _neg_large1 * _pos_large2;
+
+    // half products below toom3_threshold, full products from it
+    for (size_t threshold : {_toom3_threshold, size_t(1)})
+    {
+        BigInteger::toom3_threshold = threshold;
+        BarrettReducer reducer(modulus);
+
+        ASSERT_EQ(reducer.modulus(), modulus);
+        ASSERT_EQ(reducer.reduce(a), a % modulus);
+        ASSERT_EQ(reducer.reduce(b), b % modulus + modulus);
+        ASSERT_EQ(reducer.reduce(modulus), _pos_zero);
+        ASSERT_EQ(reducer.reduce(-modulus), _pos_zero);
+        ASSERT_EQ(reducer.reduce(modulus - 1), modulus - 1);
+        ASSERT_EQ(reducer.reduce(modulus * modulus - 1), modulus - 1);
+        ASSERT_EQ(reducer.reduce(a * a * a), a * a * a % modulus);
+
+        BigInteger x = reducer.reduce(a);
+        BigInteger y = reducer.reduce(b);
+        ASSERT_EQ(reducer.multiply(x, y), (x * y) % modulus);
+        ASSERT_EQ(reducer.square(y), y.square() % modulus);
+        ASSERT_EQ(reducer.power(BigInteger(3), BigInteger(1000)), BigInteger::pow(BigInteger(3), 1000) % modulus);
+    }
+    BigInteger::toom3_threshold = _toom3_threshold;
+
+    BarrettReducer single(BigInteger(1000));
+    ASSERT_EQ(single.reduce(BigInteger(-1)), BigInteger(999));
+    ASSERT_EQ(single.reduce(BigInteger(123456789)), BigInteger(789));
+
+    ASSERT_THROW(BarrettReducer(BigInteger(0)), std::invalid_argument);
+    ASSERT_THROW(BarrettReducer(BigInteger(-4)), std::invalid_argument);
+}
+
+TEST_F(TestBigInteger, TestModInt)
+{
+    // an odd (Montgomery) and an even (Barrett) modulus
+    for (const BigInteger& modulus : {(BigInteger(1) << 127) - 1, (BigInteger(1) << 130) * BigInteger(9) + 6})
+    {
+        ModularContext context(modulus);
+        ASSERT_EQ(context.modulus(), modulus);
+
+        ModInt a(_pos_large1, context);
+        ModInt b(_neg_large2, context);
+        BigInteger x = _pos_large1 % modulus;
+        BigInteger y = _neg_large2 % modulus + modulus;
+
+        ASSERT_EQ(a.value(), x);
+        ASSERT_EQ(b.value(), y);
+        ASSERT_EQ((a + b).value(), (x + y) % modulus);
+        ASSERT_EQ((a - b).value(), ((x - y) % modulus + modulus) % modulus);
+        ASSERT_EQ((-a).value(), modulus - x);
+        ASSERT_EQ((+a).value(), x);
+        ASSERT_EQ((a * b).value(), x * y % modulus);
+        ASSERT_EQ((a * a).value(), x.square() % modulus);
+        ASSERT_EQ(a.pow(BigInteger(12345)).value(), BigInteger::powmod(x, BigInteger(12345), modulus));
+        ASSERT_EQ(a.pow(_pos_zero).value(), BigInteger(1));
+
+        ModInt one(BigInteger(1), context);
+        ModInt c(BigInteger(12347), context);
+        ASSERT_EQ(c * c.inverse(), one);
+        ASSERT_EQ(c.pow(BigInteger(-3)) * c.pow(BigInteger(3)), one);
+        ASSERT_EQ(a * c / c, a);
+        ASSERT_NE(a, b);
+
+        ModInt sum = a;
+        sum += b;
+        sum -= b;
+        sum *= c;
+        sum /= c;
+        ASSERT_EQ(sum, a);
+    }
+
+    ModularContext even(BigInteger(1000));
+    ASSERT_THROW(ModInt(BigInteger(10), even).inverse(), std::domain_error);
+    ASSERT_EQ(ModInt(BigInteger(7), even).inverse().value(), BigInteger(143));
+
+    ModularContext other(BigInteger(999));
+    ASSERT_THROW(ModInt(BigInteger(1), even) + ModInt(BigInteger(1), other), std::invalid_argument);
+    ASSERT_THROW(ModularContext(BigInteger(-5)), std::invalid_argument);
+}
+
+TEST_F(TestBigInteger, TestNumberTheory)
+{
+    BigInteger common("340282366920938463463374607431768211507");     // prime
+    BigInteger a = _pos_large1 * common;
+    BigInteger b = _neg_large2 * common;
+
+    ASSERT_EQ(BigInteger::gcd(BigInteger(12), BigInteger(-18)), BigInteger(6));
+    ASSERT_EQ(BigInteger::gcd(_pos_zero, BigInteger(-5)), BigInteger(5));
+    ASSERT_EQ(BigInteger::gcd(_pos_zero, _pos_zero), _pos_zero);
+    ASSERT_EQ(BigInteger::gcd(a, b) % common, _pos_zero);
+    ASSERT_EQ(BigInteger::lcm(BigInteger(-4), BigInteger(6)), BigInteger(12));
+    ASSERT_EQ(BigInteger::lcm(_pos_zero, BigInteger(6)), _pos_zero);
+    ASSERT_EQ(BigInteger::lcm(a, b) * BigInteger::gcd(a, b), -(a * b));
+
+    {
+        auto [g, x, y] = BigInteger::extended_gcd(a, b);
+        ASSERT_EQ(g, BigInteger::gcd(a, b));
+        ASSERT_EQ(a * x + b * y, g);
+    }
+    {
+        auto [g, x, y] = BigInteger::extended_gcd(BigInteger(-240), BigInteger(46));
+        ASSERT_EQ(g, BigInteger(2));
+        ASSERT_EQ(BigInteger(-240) * x + BigInteger(46) * y, g);
+    }
+    {
+        // lehmer steps over many limbs, with a common factor and in both orders
+        BigInteger factor = random_number(200);
+        BigInteger u = random_number(2000) * factor;
+        BigInteger v = random_number(1500) * factor;
+        for (const auto& [p, q] : {std::pair(u, v), std::pair(v, u)})
+        {
+            auto [g, x, y] = BigInteger::extended_gcd(p, q);
+            ASSERT_EQ(g, BigInteger::gcd(p, q));
+            ASSERT_EQ(p * x + q * y, g);
+            ASSERT_LE(x.bit_length(), q.bit_length());
+            ASSERT_LE(y.bit_length(), p.bit_length());
+        }
+
+        BigInteger modulus = (BigInteger(1) << 4423) - 1;
+        BigInteger inverse = BigInteger::mod_inverse(u, modulus);
+        ASSERT_EQ((inverse * u - 1) % modulus, _pos_zero);
+        ASSERT_GE(inverse, _pos_zero);
+    }
+
+    ASSERT_EQ(BigInteger::mod_inverse(BigInteger(3), BigInteger(11)), BigInteger(4));
+    ASSERT_EQ(BigInteger::mod_inverse(BigInteger(-3), BigInteger(11)), BigInteger(7));
+    ASSERT_EQ(BigInteger::mod_inverse(_pos_large1, common) * _pos_large1 % common, BigInteger(1));
+    ASSERT_THROW(BigInteger::mod_inverse(BigInteger(6), BigInteger(9)), std::domain_error);
+    ASSERT_THROW(BigInteger::mod_inverse(BigInteger(6), _pos_zero), std::invalid_argument);
+
+    // x = 2 (mod 3), 3 (mod 5), 2 (mod 7)
+    ASSERT_EQ(BigInteger::crt({BigInteger(2), BigInteger(3), BigInteger(2)}, {BigInteger(3), BigInteger(5), BigInteger(7)}), BigInteger(23));
+    ASSERT_EQ(BigInteger::crt({BigInteger(-1)}, {BigInteger(10)}), BigInteger(9));
+
+    // a large value recovered from its residues modulo many word-sized primes
+    std::vector<BigInteger> primes;
+    for (int64_t p = 1000003; primes.size() < 300; p += 2)
+    {
+        bool prime = true;
+        for (int64_t d = 3; d * d <= p && prime; d += 2)
+        {
+            prime = (p % d != 0);
+        }
+        if (prime)
+        {
+            primes.push_back(BigInteger(p));
+        }
+    }
+
+    BigInteger value = _pos_large1 * _pos_large2 * _pos_large1;
+    std::vector<BigInteger> residues;
+    for (const BigInteger& p : primes)
+    {
+        residues.push_back(value % p);
+    }
+    ASSERT_EQ(BigInteger::crt(residues, primes), value);
+
+    ASSERT_THROW(BigInteger::crt({BigInteger(1)}, {}), std::invalid_argument);
+    ASSERT_THROW(BigInteger::crt({BigInteger(1)}, {BigInteger(0)}), std::invalid_argument);
+    ASSERT_THROW(BigInteger::crt({BigInteger(1), BigInteger(2)}, {BigInteger(4), BigInteger(6)}), std::domain_error);
+}
+
+TEST_F(TestBigInteger, TestMoveSemantics)
+{
+    {
+        BigInteger source = _neg_large1;
+        BigInteger moved(std::move(source));
+        ASSERT_EQ(moved, _neg_large1);
+        ASSERT_EQ(source, _pos_zero);   // NOLINT(bugprone-use-after-move)
+    }
+    {
+        BigInteger source = _pos_large2;
+        BigInteger target;
+        target = std::move(source);
+        ASSERT_EQ(target, _pos_large2);
+        ASSERT_EQ(source, _pos_zero);   // NOLINT(bugprone-use-after-move)
+    }
+
+    // every lvalue / rvalue combination of the operands
+    BigInteger a = _pos_large1;
+    BigInteger b = _neg_large2;
+    BigInteger sum = _pos_large1 + _neg_large2;
+    BigInteger diff = _pos_large1 - _neg_large2;
+
+    ASSERT_EQ(BigInteger(a) + b, sum);
+    ASSERT_EQ(a + BigInteger(b), sum);
+    ASSERT_EQ(BigInteger(a) + BigInteger(b), sum);
+    ASSERT_EQ(BigInteger(a) - b, diff);
+    ASSERT_EQ(a - BigInteger(b), diff);
+    ASSERT_EQ(BigInteger(a) - BigInteger(b), diff);
+    ASSERT_EQ(-BigInteger(a), _neg_large1);
+
+    // chained expression with temporaries on both sides
+    ASSERT_EQ(a * b + _pos_num1 * _pos_num2 - _neg_num1, BigInteger("-121932631137021795226185032733622923332237463801110425412505"));
+}
+
+TEST_F(TestBigInteger, TestSmallValues)
+{
+    // values around the 64 and 128 bit boundaries of the inline storage
+    BigInteger max64("18446744073709551615");
+    BigInteger max128("340282366920938463463374607431768211455");
+    BigInteger two128("340282366920938463463374607431768211456");
+
+    ASSERT_EQ(max64 + BigInteger(1), BigInteger("18446744073709551616"));
+    ASSERT_EQ(-max64 - BigInteger(1), BigInteger("-18446744073709551616"));
+    ASSERT_EQ(max64 - BigInteger("18446744073709551616"), BigInteger(-1));
+    ASSERT_EQ(BigInteger(5) - BigInteger(7), BigInteger(-2));
+    ASSERT_EQ(BigInteger(-5) + BigInteger(5), _pos_zero);
+    ASSERT_EQ(max64 * max64, BigInteger("340282366920938463426481119284349108225"));
+    ASSERT_EQ(max64 * -max64, BigInteger("-340282366920938463426481119284349108225"));
+    ASSERT_EQ(max128 + BigInteger(1), two128);
+    ASSERT_EQ(two128 - BigInteger(1), max128);
+    ASSERT_EQ(max128 / max64, BigInteger("18446744073709551617"));
+    ASSERT_EQ(max128 % BigInteger(-1000000007), BigInteger("279632276"));
+    ASSERT_EQ(-max128 / BigInteger(1000000007), BigInteger("-340282364538961911690641225597"));
+    ASSERT_EQ(-max128 % BigInteger(1000000007), BigInteger("-279632276"));
+    ASSERT_EQ(two128 / max128, BigInteger(1));
+    ASSERT_EQ(two128 % max128, BigInteger(1));
+
+    // growing from inline to heap storage and back
+    BigInteger value(1);
+    for (int i = 0; i < 200; i++)
+    {
+        value *= BigInteger(3);
+    }
+    for (int i = 0; i < 200; i++)
+    {
+        value /= BigInteger(3);
+    }
+    ASSERT_EQ(value, BigInteger(1));
+}
+
+TEST_F(TestBigInteger, TestMultiplicationAlgorithms)
+{
+    // balanced and unbalanced operands, up to ~450 limbs
+    std::vector<std::pair<BigInteger, BigInteger>> operands = {
+        {random_number(3000), random_number(3000)},
+        {random_number(8500), random_number(7000)},
+        {random_number(8500), random_number(900)},
+        {random_number(5000), random_number(2600)},
+    };
+
+    std::vector<BigInteger> expected;
+    std::vector<BigInteger> squares;
+    BigInteger::karatsuba_threshold = std::numeric_limits<size_t>::max();
+    for (const auto& [a, b] : operands)
+    {
+        expected.push_back(a * b);
+        squares.push_back(a * BigInteger(a));   // a copy, so the general schoolbook path
+    }
+
+    std::vector<std::tuple<size_t, size_t, size_t>> settings = {
+        {4, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max()},    // Karatsuba only
+        {4, 8, std::numeric_limits<size_t>::max()},                                     // Toom-3
+        {4, 8, 8},                                                                      // Toom-4
+        {_karatsuba_threshold, _toom3_threshold, _toom4_threshold},                     // defaults
+    };
+
+    for (const auto& [k, t3, t4] : settings)
+    {
+        BigInteger::karatsuba_threshold = k;
+        BigInteger::toom3_threshold = t3;
+        BigInteger::toom4_threshold = t4;
+
+        for (size_t i = 0; i < operands.size(); i++)
+        {
+            ASSERT_EQ(operands[i].first * operands[i].second, expected[i]);
+            ASSERT_EQ(operands[i].second * operands[i].first, expected[i]);
+            ASSERT_EQ(operands[i].first.square(), squares[i]);
+            ASSERT_EQ(operands[i].first * operands[i].first, squares[i]);
+        }
+    }
+
+    // (10^n - 1) * (10^m - 1) = 10^(n + m) - 10^n - 10^m + 1
+    {
+        BigInteger a(std::string(4000, '9'));
+        BigInteger b(std::string(2500, '9'));
+        std::string product = std::string(2499, '9') + "8" + std::string(1500, '9') + std::string(2499, '0') + "1";
+        ASSERT_EQ(a * b, BigInteger(product));
+    }
+
+    // (10^n - 1)^2 = 10^2n - 2 * 10^n + 1
+    {
+        BigInteger a(std::string(3000, '9'));
+        std::string square = std::string(2999, '9') + "8" + std::string(2999, '0') + "1";
+        ASSERT_EQ(a.square(), BigInteger(square));
+        ASSERT_EQ(BigInteger(-7).square(), BigInteger(49));
+        ASSERT_EQ(_pos_zero.square(), _pos_zero);
+    }
+}
+
+TEST_F(TestBigInteger, TestNttMultiplication)
+{
+    // all 32-bit transform pieces at their maximum: 2^(64 * 700) - 1
+    BigInteger all_ones(1);
+    for (size_t i = 0; i < 700; i++)
+    {
+        all_ones *= BigInteger("18446744073709551616");
+    }
+    all_ones -= BigInteger(1);
+
+    std::vector<std::pair<BigInteger, BigInteger>> operands = {
+        {random_number(2000), random_number(2000)},
+        {random_number(30000), random_number(25000)},
+        {random_number(30000), random_number(3000)},
+        {random_number(12345), random_number(12345)},
+        {all_ones, all_ones},
+        {all_ones, random_number(11000)},
+    };
+
+    for (const auto& [a, b] : operands)
+    {
+        BigInteger::karatsuba_threshold = std::numeric_limits<size_t>::max();
+        BigInteger schoolbook = a * b;
+        BigInteger square = a * a;
+
+        BigInteger::karatsuba_threshold = _karatsuba_threshold;
+        BigInteger::ntt_threshold = 16;
+        ASSERT_EQ(a * b, schoolbook);
+        ASSERT_EQ(a * a, square);
+
+        BigInteger::ntt_threshold = _ntt_threshold;
+    }
+}
+
+TEST_F(TestBigInteger, TestDivision)
+{
+    for (size_t threshold : {_burnikel_ziegler_threshold, size_t(2), size_t(5)})   // Knuth D, then forced recursion
+    {
+        BigInteger::burnikel_ziegler_threshold = threshold;
+
+        for (size_t a_digits : {20, 40, 200, 1500, 6000})
+        {
+            for (size_t b_digits : {20, 39, 100, 700, 2900})
+            {
+                BigInteger a = random_number(a_digits);
+                BigInteger b = random_number(b_digits);
+
+                BigInteger quotient = a / b;
+                BigInteger remainder = a % b;
+
+                ASSERT_EQ(quotient * b + remainder, a);
+                ASSERT_LT(remainder < BigInteger(0) ? -remainder : remainder, b < BigInteger(0) ? -b : b);
+                ASSERT_TRUE(remainder == BigInteger(0) || (remainder < BigInteger(0)) == (a < BigInteger(0)));
+
+                auto [q, r] = a.divmod(b);
+                ASSERT_EQ(q, quotient);
+                ASSERT_EQ(r, remainder);
+
+                ASSERT_EQ((a - remainder).divexact(b), quotient);
+                ASSERT_EQ((a * b).divexact(a), b);
+            }
+        }
+    }
+
+    BigInteger::burnikel_ziegler_threshold = _burnikel_ziegler_threshold;
+
+    // divisor with a top limb that needs no normalization shift, remainder one below the divisor
+    {
+        BigInteger b("340282366920938463463374607431768211455");     // 2^128 - 1
+        BigInteger q("98765432109876543210987654321");
+        BigInteger r = b - BigInteger(1);
+        BigInteger a = b * q + r;
+        ASSERT_EQ(a / b, q);
+        ASSERT_EQ(a % b, r);
+    }
+
+    // exact division by divisors with factors of two, single limbs and signs
+    {
+        BigInteger q("-98765432109876543210987654321098765432109876543210");
+        BigInteger d = BigInteger::pow(BigInteger(2), 100) * BigInteger(3) * BigInteger(1000000007);
+        ASSERT_EQ((q * d).divexact(d), q);
+        ASSERT_EQ((q * d).divexact(-d), -q);
+        ASSERT_EQ((q * BigInteger(96)).divexact(BigInteger(-96)), -q);
+        ASSERT_EQ(q.divexact(BigInteger(1)), q);
+        ASSERT_EQ(_pos_zero.divexact(d), _pos_zero);
+        ASSERT_THROW(q.divexact(_pos_zero), std::logic_error);
+    }
+}
+
+TEST_F(TestBigInteger, TestGcdAlgorithms)
+{
+    auto euclid = [](BigInteger a, BigInteger b) {
+        while (b != BigInteger(0))
+        {
+            a = a % b;
+            std::swap(a, b);
+        }
+        return a < BigInteger(0) ? -a : a;
+    };
+
+    // a common factor, operands of very different length, consecutive fibonacci numbers
+    // with all quotients one, a multiple and coprime neighbours
+    BigInteger common = random_number(1000, false);
+    BigInteger f0(1);
+    BigInteger f1(1);
+    while (f1.bit_length() < 20000)
+    {
+        f0 += f1;
+        std::swap(f0, f1);
+    }
+    std::vector<std::pair<BigInteger, BigInteger>> operands = {
+        {common * random_number(9000, false), -common * random_number(7000, false)},
+        {random_number(12000, false), random_number(300, false)},
+        {f1, f0},
+        {common, common * random_number(5000, false)},
+        {random_number(3000, false) * BigInteger::pow(BigInteger(2), 700), BigInteger::pow(BigInteger(2), 900)},
+    };
+    operands.push_back({operands[1].first, operands[1].first + BigInteger(1)});
+
+    std::vector<BigInteger> expected;
+    for (const auto& [a, b] : operands)
+    {
+        expected.push_back(euclid(a, b));
+    }
+
+    for (size_t threshold : {_half_gcd_threshold, size_t(8), size_t(40)})     // Lehmer, then forced recursion
+    {
+        BigInteger::half_gcd_threshold = threshold;
+
+        for (size_t i = 0; i < operands.size(); i++)
+        {
+            ASSERT_EQ(BigInteger::gcd(operands[i].first, operands[i].second), expected[i]);
+            ASSERT_EQ(BigInteger::gcd(operands[i].second, operands[i].first), expected[i]);
+        }
+    }
+
+    BigInteger::half_gcd_threshold = _half_gcd_threshold;
+
+    ASSERT_EQ(BigInteger::gcd(f1, f0), BigInteger(1));
+    ASSERT_EQ(BigInteger::gcd(operands[0].first, operands[0].second) % common, BigInteger(0));
+    ASSERT_EQ(BigInteger::gcd(BigInteger("340282366920938463463374607431768211456"), BigInteger(-96)), BigInteger(32));
+}
+
+TEST_F(TestBigInteger, TestDecimalConversion)
+{
+    std::mt19937_64 rng(23);
+    std::string digits(20000, '0');
+    for (char& c : digits)
+    {
+        c = static_cast<char>('0' + rng() % 10);
+    }
+    digits[0] = '4';
+
+    // runs of zeros at the split points, and a value known without parsing
+    std::string sparse = "1" + std::string(4863, '0') + "7" + std::string(3000, '0') + "1";
+    BigInteger sparse_value = BigInteger::pow(BigInteger(10), 7865) + BigInteger(7) * BigInteger::pow(BigInteger(10), 3001) + 1;
+
+    for (size_t threshold : {_radix_threshold, size_t(2), size_t(5)})
+    {
+        BigInteger::radix_threshold = threshold;
+
+        for (const std::string& str : {digits, "-" + digits, sparse})
+        {
+            std::ostringstream out;
+            out << BigInteger(str);
+            ASSERT_EQ(out.str(), str);
+        }
+
+        ASSERT_EQ(BigInteger(sparse), sparse_value);
+        ASSERT_EQ(BigInteger("000" + digits), BigInteger(digits));
+        ASSERT_EQ(BigInteger(digits), BigInteger(digits.substr(0, 9000)) * BigInteger::pow(BigInteger(10), 11000) + BigInteger(digits.substr(9000)));
+    }
+}
+
+TEST_F(TestBigInteger, TestRadixConversion)
+{
+    BigInteger two128("340282366920938463463374607431768211456");
+
+    ASSERT_EQ(BigInteger::from_string("ff", 16), BigInteger(255));
+    ASSERT_EQ(BigInteger::from_string("-DeadBeef", 16), BigInteger(-3735928559));
+    ASSERT_EQ(BigInteger::from_string("+777", 8), BigInteger(511));
+    ASSERT_EQ(BigInteger::from_string("-0", 2), _pos_zero);
+    ASSERT_EQ(BigInteger::from_string("1" + std::string(128, '0'), 2), two128);
+    ASSERT_EQ(BigInteger::from_string("zz", 36), BigInteger(1295));
+    ASSERT_EQ(BigInteger::from_string("12345"), _pos_num1);
+
+    ASSERT_EQ(two128.to_string(16), "1" + std::string(32, '0'));
+    ASSERT_EQ((two128 - 1).to_string(32), "7" + std::string(25, 'v'));
+    ASSERT_EQ(_neg_num2.to_string(36), "-1gdu");
+    ASSERT_EQ(_pos_zero.to_string(7), "0");
+    ASSERT_EQ(_neg_large1.to_string(), "-123456789012345678901234567890");
+
+    ASSERT_THROW(BigInteger::from_string("12", 1), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from_string("12", 37), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from_string("", 16), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from_string("-", 16), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from_string("19", 8), std::invalid_argument);
+    ASSERT_THROW(BigInteger::from_string("0x1f", 16), std::invalid_argument);
+    ASSERT_THROW(_pos_num1.to_string(0), std::invalid_argument);
+
+    // every base round trips, at sizes on both sides of the split
+    BigInteger::radix_threshold = 3;
+
+    BigInteger value = BigInteger::pow(BigInteger(3), 9000) - BigInteger::pow(BigInteger(2), 4000);
+    for (int base = 2; base <= 36; base++)
+    {
+        ASSERT_EQ(BigInteger::from_string(value.to_string(base), base), value);
+        ASSERT_EQ(BigInteger::from_string((-_pos_large2).to_string(base), base), -_pos_large2);
+    }
+    ASSERT_EQ(BigInteger::pow(BigInteger(7), 3000).to_string(7), "1" + std::string(3000, '0'));
+
+    BigInteger::radix_threshold = _radix_threshold;
+
+    // stream manipulators
+    {
+        std::ostringstream out;
+        out << std::hex << BigInteger(-255) << " " << std::showbase << two128 << " " << std::uppercase << BigInteger(48879)
+            << " " << std::oct << BigInteger(8) << " " << _pos_zero << " " << std::dec << _pos_num1;
+        ASSERT_EQ(out.str(), "-ff 0x100000000000000000000000000000000 0XBEEF 010 0 12345");
+    }
+}
+
+TEST_F(TestBigInteger, TestSerialization)
+{
+    using Bytes = std::vector<uint8_t>;
+
+    // raw bytes
+    ASSERT_EQ(BigInteger(0x0102).to_bytes(), (Bytes{0x01, 0x02}));
+    ASSERT_EQ(BigInteger(0x0102).to_bytes(std::endian::little), (Bytes{0x02, 0x01}));
+    ASSERT_EQ(BigInteger(-0x0102).to_bytes(), (Bytes{0x01, 0x02}));
+    ASSERT_EQ(BigInteger(128).to_bytes(std::endian::big, true), (Bytes{0x00, 0x80}));
+    ASSERT_EQ(BigInteger(-128).to_bytes(std::endian::big, true), (Bytes{0x80}));
+    ASSERT_EQ(BigInteger(-129).to_bytes(std::endian::little, true), (Bytes{0x7f, 0xff}));
+    ASSERT_EQ(_neg_one.to_bytes(std::endian::big, true), (Bytes{0xff}));
+    ASSERT_TRUE(_pos_zero.to_bytes().empty());
+
+    ASSERT_EQ(BigInteger::from_bytes(Bytes{0xff, 0xfe}), BigInteger(0xfffe));
+    ASSERT_EQ(BigInteger::from_bytes(Bytes{0xff, 0xfe}, std::endian::big, true), BigInteger(-2));
+    ASSERT_EQ(BigInteger::from_bytes(Bytes{0xfe, 0xff}, std::endian::little, true), BigInteger(-2));
+    ASSERT_EQ(BigInteger::from_bytes(Bytes{0x00, 0x00, 0x01}), _pos_one);
+    ASSERT_EQ(BigInteger::from_bytes(Bytes{}), _pos_zero);
+
+    uint8_t buffer[17] = {0x80};
+    ASSERT_EQ(BigInteger::from_bytes({buffer, sizeof(buffer)}, std::endian::big, true), -(BigInteger(1) << 135));
+
+    for (const BigInteger& value : {_pos_large1, _neg_large2, BigInteger(INT64_MIN), -(BigInteger(1) << 640), _pos_zero})
+    {
+        for (std::endian order : {std::endian::big, std::endian::little})
+        {
+            ASSERT_EQ(BigInteger::from_bytes(value.to_bytes(order, true), order, true), value);
+        }
+    }
+
+    // records
+    ASSERT_EQ(_pos_zero.serialize(), (Bytes{1, 0, 0}));
+    ASSERT_EQ(BigInteger(-300).serialize(), (Bytes{1, 1, 2, 0x2c, 0x01}));
+
+    BigInteger large = BigInteger::pow(BigInteger(3), 1000) * BigInteger(-1);
+    Bytes record = large.serialize();
+    ASSERT_EQ(record.size(), 4 + large.to_bytes().size());     // version, sign and a two byte count
+    ASSERT_EQ(BigInteger::deserialize(record), large);
+
+    std::stringstream stream;
+    large.serialize(stream);
+    _pos_num1.serialize(stream);
+    ASSERT_EQ(BigInteger::deserialize(stream), large);
+    ASSERT_EQ(BigInteger::deserialize(stream), _pos_num1);
+    ASSERT_THROW(BigInteger::deserialize(stream), std::invalid_argument);
+
+    size_t consumed = 0;
+    Bytes two = _neg_num1.serialize();
+    two.insert(two.end(), record.begin(), record.end());
+    ASSERT_EQ(BigInteger::deserialize(two, &consumed), _neg_num1);
+    ASSERT_EQ(BigInteger::deserialize(std::span(two).subspan(consumed)), large);
+    ASSERT_THROW(BigInteger::deserialize(two), std::invalid_argument);
+
+    ASSERT_THROW(BigInteger::deserialize(Bytes{2, 0, 0}), std::invalid_argument);          // version
+    ASSERT_THROW(BigInteger::deserialize(Bytes{1, 0, 2, 0x2c}), std::invalid_argument);    // truncated
+    ASSERT_THROW(BigInteger::deserialize(Bytes{1, 0, 1, 0x00}), std::invalid_argument);    // leading zero byte
+    ASSERT_THROW(BigInteger::deserialize(Bytes{1, 1, 0}), std::invalid_argument);          // negative zero
+    ASSERT_THROW(BigInteger::deserialize(Bytes{1, 2, 0}), std::invalid_argument);          // sign
 }
 
 #if SUPPORT_MORE_OPS == 1
@@ -257,6 +1121,74 @@ TEST_F(TestBigInteger, TestMoreOperators)
             (void)tmp;
         }, std::exception);
     }
+    {
+        // around squares of roots from one limb to the recursive sizes
+        for (size_t bits : {31, 52, 53, 64, 100, 200, 1000, 5000, 40000})
+        {
+            BigInteger root = (BigInteger(1) << bits) - 12345;
+            BigInteger square = root.square();
+            ASSERT_EQ(square.isqrt(), root);
+            ASSERT_EQ((square - 1).isqrt(), root - 1);
+            ASSERT_EQ((square + 2 * root).isqrt(), root);
+            ASSERT_EQ((square + 2 * root + 1).isqrt(), root + 1);
+        }
+    }
+
+    // sqrtrem
+    {
+        auto [root, remainder] = BigInteger("150").sqrtrem();
+        ASSERT_EQ(root, BigInteger(12));
+        ASSERT_EQ(remainder, BigInteger(6));
+    }
+    {
+        BigInteger num = BigInteger::pow(BigInteger(10), 10000) + 7;
+        auto [root, remainder] = num.sqrtrem();
+        ASSERT_EQ(root, BigInteger::pow(BigInteger(10), 5000));
+        ASSERT_EQ(remainder, BigInteger(7));
+    }
+
+    // iroot
+    {
+        ASSERT_EQ(BigInteger(26).iroot(3), BigInteger(2));
+        ASSERT_EQ(BigInteger(27).iroot(3), BigInteger(3));
+        ASSERT_EQ(BigInteger(-28).iroot(3), BigInteger(-3));
+        ASSERT_EQ(_pos_num1.iroot(1), _pos_num1);
+        ASSERT_EQ(_pos_num1.iroot(2), _pos_num1.isqrt());
+        ASSERT_EQ(_pos_num1.iroot(100), BigInteger(1));
+        ASSERT_EQ(_pos_zero.iroot(5), _pos_zero);
+        ASSERT_THROW(_pos_num1.iroot(0), std::invalid_argument);
+        ASSERT_THROW(_neg_num1.iroot(4), std::runtime_error);
+    }
+    {
+        for (uint64_t k : {3, 5, 7, 64, 97})
+        {
+            BigInteger root = BigInteger::pow(BigInteger(3), 2000 / k + 40) + 1;
+            BigInteger power = BigInteger::pow(root, k);
+            ASSERT_EQ(power.iroot(k), root);
+            ASSERT_EQ((power - 1).iroot(k), root - 1);
+            if (k % 2 == 1)
+            {
+                ASSERT_EQ((-power).iroot(k), -root);
+            }
+        }
+    }
+
+    // is_perfect_power
+    {
+        ASSERT_TRUE(_pos_zero.is_perfect_power());
+        ASSERT_TRUE(_pos_one.is_perfect_power());
+        ASSERT_TRUE(BigInteger(-1).is_perfect_power());
+        ASSERT_FALSE(BigInteger(2).is_perfect_power());
+        ASSERT_TRUE(BigInteger(1024).is_perfect_power());
+        ASSERT_TRUE(BigInteger(-27).is_perfect_power());
+        ASSERT_FALSE(BigInteger(-4).is_perfect_power());
+        ASSERT_TRUE(BigInteger(-64).is_perfect_power());
+        ASSERT_FALSE(_pos_num1.is_perfect_power());
+        ASSERT_TRUE(BigInteger::pow(BigInteger(10), 99).is_perfect_power());
+        ASSERT_TRUE(BigInteger::pow(BigInteger("123456789123456789"), 13).is_perfect_power());
+        ASSERT_FALSE((BigInteger::pow(BigInteger("123456789123456789"), 13) + 2).is_perfect_power());
+        ASSERT_FALSE(((BigInteger(1) << 127) - 1).is_perfect_power());
+    }
 
     // is_prime
     {
@@ -286,6 +1218,11 @@ TEST_F(TestBigInteger, TestMoreOperators)
         BigInteger carmichael("561");
         ASSERT_FALSE(carmichael.is_prime(5));
     }
+    {
+        BigInteger mersenne = (BigInteger(1) << 521) - 1;
+        ASSERT_TRUE(mersenne.is_prime(5));
+        ASSERT_FALSE((mersenne + 2).is_prime(5));
+    }
 }
 
 #endif
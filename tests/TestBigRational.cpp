@@ -17,6 +17,13 @@ protected:
     BigRational _pos = BigRational(3, 4);
     BigRational _neg= BigRational(-3, 4);
 
+    // put back even when an assertion returns early
+    const size_t _growth_threshold = BigRationalAccumulator::growth_threshold;
+
+    void TearDown() override
+    {
+        BigRationalAccumulator::growth_threshold = _growth_threshold;
+    }
 };
 
 TEST_F(TestBigRational, TestConstructor)
@@ -69,6 +76,34 @@ TEST_F(TestBigRational, TestUnary)
     }
 }
 
+TEST_F(TestBigRational, TestMoveSemantics)
+{
+    {
+        BigRational source = _neg;
+        BigRational moved(std::move(source));
+        ASSERT_EQ(moved, _neg);
+        ASSERT_EQ(source, _zero);   // NOLINT(bugprone-use-after-move)
+    }
+    {
+        BigRational source = _third;
+        BigRational target;
+        target = std::move(source);
+        ASSERT_EQ(target, _third);
+        ASSERT_EQ(source, _zero);   // NOLINT(bugprone-use-after-move)
+    }
+
+    ASSERT_EQ(BigRational(_half) + _third, BigRational(5, 6));
+    ASSERT_EQ(_half + BigRational(_third), BigRational(5, 6));
+    ASSERT_EQ(_half - BigRational(_third), BigRational(1, 6));
+    ASSERT_EQ(BigRational(_half) - BigRational(_third), BigRational(1, 6));
+    ASSERT_EQ(_pos * BigRational(_neg), BigRational(-9, 16));
+    ASSERT_EQ(BigRational(_pos) / _neg, BigRational(-1, 1));
+    ASSERT_EQ(-BigRational(_pos), _neg);
+
+    // a*b + c*d - e
+    ASSERT_EQ(_half * _third + _pos * _neg - _one, BigRational(-67, 48));
+}
+
 TEST_F(TestBigRational, TestLogicalOperators)
 {
     BigRational two_four(2,4);
@@ -85,6 +120,20 @@ TEST_F(TestBigRational, TestLogicalOperators)
     ASSERT_LE(_half, two_four);
     ASSERT_LE(_half, _pos);
     ASSERT_GE(_pos, _half);
+
+    // values apart in magnitude, agreeing in their leading bits, and equal only in the last digit
+    BigRational big("123456789012345678901234567890123456789", "7");
+    BigRational tiny("7", "123456789012345678901234567890123456789");
+    BigRational close("1234567890123456789012345678901234567890", "70");
+    BigRational closer("12345678901234567890123456789012345678901", "700");
+    ASSERT_LT(tiny, big);
+    ASSERT_LT(-big, -tiny);
+    ASSERT_LT(-tiny, _zero);
+    ASSERT_EQ(big, close);
+    ASSERT_LT(big, closer);
+    ASSERT_GT(-big, -closer);
+    ASSERT_LT(BigRational(1, 3), BigRational("333333333333333333333333333333333334", "1000000000000000000000000000000000000"));
+    ASSERT_GT(BigRational(1, 3), BigRational("333333333333333333333333333333333333", "1000000000000000000000000000000000000"));
 }
 
 #if SUPPORT_IFSTREAM == 1
@@ -179,6 +228,134 @@ TEST_F(TestBigRational, TestArithmeticOperators)
             (void)tmp;
         }, std::logic_error);
     }
+
+    // Common factors of the denominators and across the operands cancel
+    {
+        ASSERT_EQ(BigRational(7, 12) + BigRational(5, 12), _one);
+        ASSERT_EQ(BigRational(5, 6) - _third, _half);
+        ASSERT_EQ(_pos - _pos, _zero);
+        ASSERT_EQ(BigRational(4, 9) * BigRational(3, 8), BigRational(1, 6));
+        ASSERT_EQ(_half / BigRational(-3, 4), BigRational(-2, 3));
+        ASSERT_EQ(_zero * _neg, _zero);
+    }
+    {
+        // operands aliasing the result
+        BigRational x = _pos;
+        x += x;
+        x *= x;
+        ASSERT_EQ(x, BigRational(9, 4));
+        x /= x;
+        ASSERT_EQ(x, _one);
+    }
+    {
+        BigRational harmonic;
+        for (int64_t k = 1; k <= 20; k++)
+        {
+            harmonic += BigRational(1, k);
+        }
+        ASSERT_EQ(harmonic, BigRational("55835135", "15519504"));
+
+        BigRational product = _one;
+        for (int64_t k = 1; k <= 100; k++)
+        {
+            product *= BigRational(k + 1, k + 3);
+        }
+        ASSERT_EQ(product, BigRational(1, 1751));
+    }
+}
+
+TEST_F(TestBigRational, TestAccumulator)
+{
+    for (size_t threshold : {_growth_threshold, size_t(0), std::numeric_limits<size_t>::max()})
+    {
+        BigRationalAccumulator::growth_threshold = threshold;
+
+        BigRationalAccumulator harmonic;
+        BigRational expected;
+        for (int64_t k = 1; k <= 60; k++)
+        {
+            harmonic += BigRational(1, k);
+            expected += BigRational(1, k);
+        }
+        ASSERT_EQ(harmonic, expected);
+        ASSERT_EQ(harmonic.value(), expected);
+
+        BigRationalAccumulator product = _one;
+        for (int64_t k = 1; k <= 60; k++)
+        {
+            product *= BigRational(k + 1, k + 3);
+            product /= BigRational(-1, 1);
+        }
+        ASSERT_EQ(product.value(), BigRational(1, 651));
+    }
+
+    BigRationalAccumulator::growth_threshold = std::numeric_limits<size_t>::max();
+
+    // unreduced values compare exactly: 2/4 + 2/4 = 4/4
+    BigRationalAccumulator x = BigRational(1, 2);
+    BigRationalAccumulator y = x * BigRational(2, 1) / BigRational(2, 1);
+    ASSERT_EQ(x, y);
+    ASSERT_EQ(x + y, _one);
+    ASSERT_LT(y - x, BigRational(1, 1000));
+    ASSERT_GT(y, _third);
+    ASSERT_LT(-_pos, x - y);
+    ASSERT_EQ(y - y, _zero);
+
+    y *= y;
+    y.normalize();
+    ASSERT_EQ(y.value(), BigRational(1, 4));
+
+    std::ostringstream out;
+    out << (x + x + x);
+    ASSERT_EQ(out.str(), "3/2");
+
+    ASSERT_THROW(x /= _zero, std::logic_error);
+}
+
+TEST_F(TestBigRational, TestConversion)
+{
+    ASSERT_EQ(_zero.to_double(), 0.0);
+    ASSERT_EQ(_third.to_double(), 1.0 / 3.0);
+    ASSERT_EQ(BigRational(-22, 7).to_double(), -22.0 / 7.0);
+    ASSERT_EQ(BigRational(1, 10).to_double(), 0.1);
+
+    // a quotient in range from parts far beyond it
+    std::string huge = "1" + std::string(500, '0');
+    ASSERT_EQ(BigRational("3" + huge.substr(1), huge).to_double(), 3.0);
+    ASSERT_EQ(BigRational(huge + "0", "3" + std::string(499, '0')).to_double(), 100.0 / 3.0);
+    ASSERT_DOUBLE_EQ(BigRational("1", "3" + std::string(300, '0')).to_double(), 1e-300 / 3.0);
+    ASSERT_THROW(BigRational(huge, "1").to_double(), std::runtime_error);
+
+    auto [mantissa, exponent] = BigRational(-3, 4096).frexp();
+    ASSERT_EQ(mantissa, -0.75);
+    ASSERT_EQ(exponent, -10);
+
+    ASSERT_DOUBLE_EQ(BigRational(huge, "1").sqrt(), 1e250);
+    ASSERT_DOUBLE_EQ(BigRational("1", huge).sqrt(), 1e-250);
+}
+
+TEST_F(TestBigRational, TestSerialization)
+{
+    using Bytes = std::vector<uint8_t>;
+
+    ASSERT_EQ(_third.serialize(), (Bytes{1, 0, 1, 1, 0, 1, 3}));
+    ASSERT_EQ(_zero.serialize(), (Bytes{1, 0, 0, 0, 1, 1}));
+
+    BigRational large("-" + std::string(300, '7'), "1" + std::string(299, '0') + "3");
+    ASSERT_EQ(BigRational::deserialize(large.serialize()), large);
+
+    std::stringstream stream;
+    large.serialize(stream);
+    _neg.serialize(stream);
+    ASSERT_EQ(BigRational::deserialize(stream), large);
+    ASSERT_EQ(BigRational::deserialize(stream), _neg);
+
+    // written in other terms, read back in lowest terms
+    ASSERT_EQ(BigRational::deserialize(Bytes{1, 1, 1, 4, 0, 1, 6}), BigRational(-2, 3));
+
+    ASSERT_THROW(BigRational::deserialize(Bytes{1, 0, 1, 1, 0, 0}), std::invalid_argument);    // zero denominator
+    ASSERT_THROW(BigRational::deserialize(Bytes{1, 0, 1, 1, 1, 1, 3}), std::invalid_argument); // negative denominator
+    ASSERT_THROW(BigRational::deserialize(Bytes{1, 0, 1, 1}), std::invalid_argument);          // truncated
 }
 
 #if SUPPORT_MORE_OPS == 1
@@ -210,6 +387,11 @@ TEST_F(TestBigRational, TestMoreOperators)
         BigInteger result = num.isqrt();
         ASSERT_EQ(result, BigInteger(1));
     }
+    {
+        // (7 * 10^600 - 1) / 7, just below (10^300)^2
+        BigRational num("6" + std::string(600, '9'), "7");
+        ASSERT_EQ(num.isqrt(), BigInteger::pow(BigInteger(10), 300) - 1);
+    }
     {
         // negative sqrt
         ASSERT_THROW({